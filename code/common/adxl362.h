@@ -60,13 +60,126 @@ extern "C"
  */
 /* ************************************************************************** */
 
+/* ADXL362 registers */
+#define ADXL362_REG_DEVID_AD            0x00
+#define ADXL362_REG_XDATA               0x08
+#define ADXL362_REG_YDATA               0x09
+#define ADXL362_REG_ZDATA               0x0A
+#define ADXL362_REG_STATUS              0x0B
+#define ADXL362_REG_FIFO_ENTRIES_L      0x0C
+#define ADXL362_REG_FIFO_ENTRIES_H      0x0D
+#define ADXL362_REG_XDATA_L             0x0E
+#define ADXL362_REG_SOFT_RESET          0x1F
+#define ADXL362_REG_THRESH_ACT_L        0x20
+#define ADXL362_REG_THRESH_ACT_H        0x21
+#define ADXL362_REG_TIME_ACT            0x22
+#define ADXL362_REG_THRESH_INACT_L      0x23
+#define ADXL362_REG_THRESH_INACT_H      0x24
+#define ADXL362_REG_TIME_INACT_L        0x25
+#define ADXL362_REG_TIME_INACT_H        0x26
+#define ADXL362_REG_ACT_INACT_CTL       0x27
+#define ADXL362_REG_FIFO_CONTROL        0x28
+#define ADXL362_REG_FIFO_SAMPLES        0x29
+#define ADXL362_REG_INTMAP1             0x2A
+#define ADXL362_REG_INTMAP2             0x2B
+#define ADXL362_REG_FILTER_CTL          0x2C
+#define ADXL362_REG_POWER_CTL           0x2D
+
+/* ADXL362 STATUS register */
+#define ADXL362_STATUS_DATA_READY       (1 << 0)
+#define ADXL362_STATUS_FIFO_READY       (1 << 1)
+#define ADXL362_STATUS_FIFO_WATERMARK   (1 << 2)
+#define ADXL362_STATUS_FIFO_OVERRUN     (1 << 3)
+#define ADXL362_STATUS_ACT              (1 << 4)
+#define ADXL362_STATUS_INACT            (1 << 5)
+#define ADXL362_STATUS_AWAKE            (1 << 6)
+#define ADXL362_STATUS_ERR_USER_REGS    (1 << 7)
+
+/* ADXL362 FIFO modes, select one with ADXL362_FIFO_MODE */
+#define ADXL362_FIFO_OFF                (0) // nAWAKE carries the AWAKE bit
+#define ADXL362_FIFO_STREAM             (2) // Newest samples, oldest dropped
+#define ADXL362_FIFO_TRIGGERED          (3) // Samples around an activity event
+
+#ifndef ADXL362_FIFO_MODE
+#define ADXL362_FIFO_MODE               ADXL362_FIFO_OFF
+#endif
+
+/*
+ * FIFO watermark in entries (one entry per axis, 511 max). The FIFO
+ * watermark replaces AWAKE on nAWAKE, so the controller wakes once per
+ * batch: 150 entries are 50 X/Y/Z samples, 4 sec at 12.5Hz.
+ */
+#ifndef ADXL362_FIFO_WATERMARK
+#define ADXL362_FIFO_WATERMARK          (150)
+#endif
+
+/*
+ * ADXL362 power and latency profiles, select one with ADXL362_PROFILE or
+ * switch with adxl362_profile(). The activity and inactivity times are
+ * counted in samples, each profile holds the counts that keep them at
+ * about 1.2 sec and 10 sec. Currents at 2.0 V from the datasheet, typical.
+ */
+#define ADXL362_PROFILE_WAKEUP          (0) // Wake-up mode, ~6 Hz, 0.27 uA
+#define ADXL362_PROFILE_12_5HZ          (1) // 12.5 Hz, normal noise
+#define ADXL362_PROFILE_50HZ            (2) // 50 Hz, normal noise
+#define ADXL362_PROFILE_100HZ_LOW_NOISE (3) // 100 Hz, low noise
+#define ADXL362_NUM_PROFILES            (4)
+
+#ifndef ADXL362_PROFILE
+#define ADXL362_PROFILE                 ADXL362_PROFILE_12_5HZ
+#endif
+
+/*
+ * Autonomous mode, built when ADXL362_AUTONOMOUS is defined. Autosleep is
+ * part of the configuration and stays on: the loop mode (ACT_INACT_CTL)
+ * drops to wake-up mode on inactivity and back on activity by itself, the
+ * controller only follows nAWAKE and sends nothing per cycle. While the
+ * controller alerts the accelerometer is in wake-up mode, one sample over
+ * the activity threshold at about 6 Hz ends the alert instead of
+ * TIME_ACT samples at 12.5 Hz.
+ */
+
+/* ADXL362 FIFO entry, LSB first */
+#define ADXL362_FIFO_AXIS(entry)        ((uint8_t)((entry) >> 14))
+#define ADXL362_FIFO_AXIS_X             (0)
+#define ADXL362_FIFO_AXIS_Y             (1)
+#define ADXL362_FIFO_AXIS_Z             (2)
+#define ADXL362_FIFO_AXIS_TEMP          (3)
+#define ADXL362_FIFO_DATA(entry)        ((int16_t)((entry) << 2) >> 2) // mg
+
+/*
+ * FIFO entry callback, called for every entry drained.
+ */
+typedef void (*adxl362_fifo_entry_t)(uint16_t entry);
+
+#if defined (HOST_BUILD)
+/*
+ * Activity and inactivity settings, fixed on a target. A host build may
+ * change them before adxl362_init() programs the accelerometer, the
+ * times then replace the counts of the profile.
+ */
+typedef struct _adxl362_params_t
+{
+    uint16_t thresh_act; // mg (+/-2g), 2047 max
+    uint16_t thresh_inact; // mg (+/-2g), 2047 max
+    uint8_t time_act; // samples
+    uint16_t time_inact; // samples
+
+} adxl362_params_t, *adxl362_params_ptr_t;
+
+extern adxl362_params_t adxl362_params;
+#endif
+
 /* ************************************************************************** */
 /*!
  \ingroup adxl362
 
  \brief adxl362_init
 
- Initializes the accelerometer peripheral.
+ Initializes the accelerometer peripheral. An accelerometer that still
+ holds the configuration after a controller-only reset is left running,
+ otherwise it is reset and configured. Define ADXL362_COLD_BOOT to always
+ reset it.
 
  \param[in] None.
 
@@ -100,9 +213,10 @@ bool adxl362_is_asleep(void);
 
  \brief adxl362_autosleep
 
- Places the accelerometer into autosleep mode.
+ Turns the accelerometer's autosleep mode on or off. Nothing is sent
+ when it already is.
 
- \param[in] None.
+ \param[in] active - true for autosleep.
 
  \return Nothing.
 
@@ -111,6 +225,122 @@ bool adxl362_is_asleep(void);
 
 void adxl362_autosleep(bool active);
 
+/* ************************************************************************** */
+/*!
+ \ingroup adxl362
+
+ \brief adxl362_profile
+
+ Switches the power and latency profile. The accelerometer is put in
+ standby for the change, the measurement restarts with the new rate and
+ its activity and inactivity timing starts over.
+
+ \param[in] profile - ADXL362_PROFILE_WAKEUP, _12_5HZ, _50HZ or
+ _100HZ_LOW_NOISE.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void adxl362_profile(uint8_t profile);
+
+/* ************************************************************************** */
+/*!
+ \ingroup adxl362
+
+ \brief adxl362_standby
+
+ Stops the measurement, the lowest power the accelerometer has. Activity
+ detection is off and INT1/INT2 are unmapped, so nothing is detected and
+ nAWAKE does not change. adxl362_init() starts it again.
+
+ \param[in] None.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void adxl362_standby(void);
+
+/* ************************************************************************** */
+/*!
+ \ingroup adxl362
+
+ \brief adxl362_stage
+
+ Stages a configuration register in the driver's shadow of THRESH_ACT_L
+ to POWER_CTL. It is only marked dirty if the value changes, nothing is
+ sent until adxl362_flush().
+
+ \param[in] reg - register address, 0x20 to 0x2D.
+ \param[in] value - register value.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void adxl362_stage(uint8_t reg, uint8_t value);
+
+/* ************************************************************************** */
+/*!
+ \ingroup adxl362
+
+ \brief adxl362_flush
+
+ Writes the dirty registers in address order, one auto-incrementing burst
+ per run of dirty registers. A burst carries on through up to two clean
+ ones rather than start again.
+
+ \param[in] None.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void adxl362_flush(void);
+
+/* ************************************************************************** */
+/*!
+ \ingroup adxl362
+
+ \brief adxl362_read_regs
+
+ Reads consecutive accelerometer registers in a single burst, the register
+ address auto-increments under one chip select assertion.
+
+ \param[in] addr - first register address.
+ \param[out] buf - register values, num_bytes long.
+ \param[in] num_bytes - number of registers to read.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void adxl362_read_regs(uint8_t addr, uint8_t * buf, uint8_t num_bytes);
+
+/* ************************************************************************** */
+/*!
+ \ingroup adxl362
+
+ \brief adxl362_fifo_drain
+
+ Reads the status and every entry held in the FIFO. The entries are read in
+ a single burst, the watermark interrupt re-arms once the FIFO is drained.
+
+ \param[in] callback - called for each entry drained, may be NULL.
+
+ \return STATUS register value read before the drain.
+
+ */
+/* ************************************************************************** */
+
+uint8_t adxl362_fifo_drain(adxl362_fifo_entry_t callback);
+
 #ifdef __cplusplus
 }
 #endif
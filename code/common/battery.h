@@ -0,0 +1,151 @@
+/*
+ ==============================================================================
+ Name        : battery.h
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+#ifndef BATTERY_H_
+#define BATTERY_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************** */
+/*!
+ \defgroup battery
+
+ \brief These APIs and definitions are for the battery monitor.
+
+ VDD is measured by converting the fixed voltage reference (FVR_MV, see
+ user.h) with the ADC referenced to VDD, VDD = FVR_MV * 1023 / count. The
+ FVR and the ADC are only on for the conversion. The thresholds are kept
+ as counts, a lower VDD gives a higher count.
+
+ The level drops as soon as VDD is below a threshold and only rises once
+ VDD is BATTERY_HYSTERESIS_MV above it again, a cell that recovers at
+ rest does not flap between levels. BATTERY_EOL takes
+ BATTERY_EOL_READINGS in a row below BATTERY_EOL_MV, one reading that
+ caught a sag does not end the device, and is then kept until a reset. A
+ new cell starts over at power-on. The controller degrades with the
+ level:
+
+ BATTERY_LOW - shorter alert beeps, no steady tone.
+ BATTERY_CRITICAL - as low, the LEDs stay dark and nothing is announced.
+ BATTERY_EOL - the accelerometer is put in standby and the core sleeps
+ for good, there are no more alerts.
+ */
+/* ************************************************************************** */
+
+// Levels, in the order they are reached
+#define BATTERY_OK          (0)
+#define BATTERY_LOW         (1)
+#define BATTERY_CRITICAL    (2)
+#define BATTERY_EOL         (3)
+
+// Thresholds, a CR2032 is 3.0 V fresh and about 2.0 V spent
+#ifndef BATTERY_LOW_MV
+#define BATTERY_LOW_MV      (2600)
+#endif
+#ifndef BATTERY_CRITICAL_MV
+#define BATTERY_CRITICAL_MV (2400)
+#endif
+#ifndef BATTERY_EOL_MV
+#define BATTERY_EOL_MV      (2200)
+#endif
+#ifndef BATTERY_HYSTERESIS_MV
+#define BATTERY_HYSTERESIS_MV (100)
+#endif
+#ifndef BATTERY_EOL_READINGS
+#define BATTERY_EOL_READINGS (3)
+#endif
+
+// ADC count of the FVR at a VDD
+#define BATTERY_COUNT(mv) \
+    ((uint16_t) (((uint32_t) FVR_MV * 1023) / (mv)))
+
+// Last conversion, read it with the debugger
+extern uint16_t battery_count;
+
+/* ************************************************************************** */
+/*!
+ \ingroup battery
+
+ \brief battery_measure
+
+ Measures VDD and updates the level. Takes well under a millisecond, call
+ it rarely, once per sleep cycle.
+
+ \param[in] None.
+
+ \return The level, BATTERY_OK to BATTERY_EOL.
+
+ */
+/* ************************************************************************** */
+
+uint8_t battery_measure(void);
+
+/* ************************************************************************** */
+/*!
+ \ingroup battery
+
+ \brief battery_level
+
+ The level of the last measurement, BATTERY_OK before the first one.
+
+ \param[in] None.
+
+ \return The level, BATTERY_OK to BATTERY_EOL.
+
+ */
+/* ************************************************************************** */
+
+uint8_t battery_level(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BATTERY_H_ */
@@ -0,0 +1,143 @@
+/*
+ ==============================================================================
+ Name        : clock.h
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************** */
+/*!
+ \defgroup clock
+
+ \brief These APIs and definitions are for the clock management module.
+
+ Switches the internal oscillator between a few clock levels at runtime.
+ Each level carries its own Timer0 prescale and reload and its own PWM
+ period, so the tick and the tone pitch hold across a switch. Nothing
+ running is moved between levels, a caller raises the clock for work that
+ needs it and puts it back when done.
+ */
+/* ************************************************************************** */
+
+// Clock levels, slowest first
+#define CLOCK_IDLE      (0) // Waiting for the tick, no tone (31 kHz), not
+                            // with the 16F1823 watchdog idle, see user.h
+#define CLOCK_RUN       (1) // Tick work and the tone (500 kHz or 8 MHz)
+#define CLOCK_FAST      (2) // SPI bursts, no tone (4 MHz or 16 MHz)
+#define CLOCK_NUM_LEVELS (3)
+
+// Fewest ticks to the next timer worth waiting at CLOCK_IDLE, every way
+// back up costs an interrupt and the switch at the idle rate
+#define CLOCK_IDLE_TICKS (8)
+
+// Timer0 reload of the current level, TIMER_RESET loads it
+extern uint8_t clock_tmr_count;
+
+/* ************************************************************************** */
+/*!
+ \ingroup clock
+
+ \brief clock_init
+
+ Starts the oscillator, Timer0 and Timer2 at the run level.
+
+ \param[in] None.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void clock_init(void);
+
+/* ************************************************************************** */
+/*!
+ \ingroup clock
+
+ \brief clock_set
+
+ Switches to a clock level. The part of the tick Timer0 has left is
+ rescaled to the new rate, and the PWM period and duty are reloaded. A
+ raise switches the oscillator first.
+
+ \param[in] level - clock level (CLOCK_IDLE, CLOCK_RUN or CLOCK_FAST).
+
+ \return uint8_t - level before the switch, to restore it with.
+
+ */
+/* ************************************************************************** */
+
+uint8_t clock_set(uint8_t level);
+
+/* ************************************************************************** */
+/*!
+ \ingroup clock
+
+ \brief clock_pwm
+
+ Loads the Timer2 prescale and PWM period of a pitch at the current
+ level, and the duty cycle to match. The pitch is kept for later level
+ switches.
+
+ \param[in] pitch - PWM_PITCH_LOW, _MID, _HIGH or _TOP (see pwm.h).
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void clock_pwm(uint8_t pitch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLOCK_H_ */
@@ -0,0 +1,142 @@
+/*
+ ==============================================================================
+ Name        : event.c
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+// Compiler specific includes
+#if defined(__XC)
+#include <xc.h>        /* XC8 General Include File */
+#elif defined(HI_TECH_C)
+#include <htc.h>       /* HiTech General Include File */
+#elif defined(__18CXX)
+#include <p18cxxx.h>   /* C18 General Include File */
+#elif defined(__MINGW32__) || defined(__unix__) || defined(__APPLE__)
+#include <registers.h> /* Host Register File */
+#endif
+
+#if defined(__XC) || defined(HI_TECH_C) || defined (HOST_BUILD)
+
+#include <stdint.h>        /* For uint8_t definition */
+#include <stdbool.h>       /* For true/false definition */
+
+#endif
+
+// Module include
+#include "event.h"
+
+// Local declarations
+
+#define EVENT_RING_MASK (EVENT_RING_SIZE - 1)
+
+#if ((256 % EVENT_RING_SIZE) != 0)
+#error EVENT_RING_SIZE must be a power of two up to 256.
+#endif
+
+static volatile uint8_t event_ring[EVENT_RING_SIZE];
+static volatile uint8_t event_head; // Next slot to post, producer only
+static volatile uint8_t event_tail; // Next slot to take, consumer only
+
+uint8_t event_dropped;
+
+// Implementation
+
+/*! \brief event_init
+ */
+void event_init(void)
+{
+    event_head = 0;
+    event_tail = 0;
+    event_dropped = 0;
+
+    return;
+}
+
+/*! \brief event_post
+ */
+bool event_post(uint8_t event)
+{
+    uint8_t head = event_head;
+
+    if ((uint8_t) (head - event_tail) == EVENT_RING_SIZE)
+    {
+        if (event_dropped != UINT8_MAX)
+        {
+            event_dropped++;
+        }
+        return false;
+    }
+
+    // Fill the slot before publishing it
+    event_ring[head & EVENT_RING_MASK] = event;
+    event_head = head + 1;
+
+    return true;
+}
+
+/*! \brief event_get
+ */
+uint8_t event_get(void)
+{
+    uint8_t tail = event_tail;
+    uint8_t event;
+
+    if (tail == event_head)
+    {
+        return EVENT_NONE;
+    }
+
+    // Take the slot before handing it back
+    event = event_ring[tail & EVENT_RING_MASK];
+    event_tail = tail + 1;
+
+    return event;
+}
+
+/*! \brief event_pending
+ */
+bool event_pending(void)
+{
+    return (event_tail != event_head);
+}
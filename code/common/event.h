@@ -0,0 +1,155 @@
+/*
+ ==============================================================================
+ Name        : event.h
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+#ifndef EVENT_H_
+#define EVENT_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************** */
+/*!
+ \defgroup event
+
+ \brief These APIs and definitions are for the event ring.
+
+ The interrupt service routine posts events, the main-loop takes them in
+ the order they were posted. The ring has a single producer and a single
+ consumer, each index is a byte written by one side only, so neither side
+ has to hold off the other. The 18F runs with one interrupt priority
+ (IPEN = 0) to keep it that way.
+ */
+/* ************************************************************************** */
+
+// Events
+#define EVENT_NONE      (0) // The ring is empty
+#define EVENT_TICK      (1) // Timer0, the main-loop tick
+#define EVENT_NAWAKE    (2) // nAWAKE edge, INT0 or IOC
+#define EVENT_PWM       (3) // Timer2, a muted tone ended its period
+
+// Ring size, a power of two that divides 256 (free-running byte indexes)
+#define EVENT_RING_SIZE (8)
+
+// Events lost to a full ring, saturates. Read it with the debugger.
+extern uint8_t event_dropped;
+
+/* ************************************************************************** */
+/*!
+ \ingroup event
+
+ \brief event_init
+
+ Empties the ring. Call it before interrupts are enabled.
+
+ \param[in] None.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void event_init(void);
+
+/* ************************************************************************** */
+/*!
+ \ingroup event
+
+ \brief event_post
+
+ Producer side, called from the interrupt service routine only. An event
+ posted to a full ring is dropped and counted in event_dropped.
+
+ \param[in] event - EVENT_TICK, EVENT_NAWAKE or EVENT_PWM.
+
+ \return true if the event was posted.
+
+ */
+/* ************************************************************************** */
+
+bool event_post(uint8_t event);
+
+/* ************************************************************************** */
+/*!
+ \ingroup event
+
+ \brief event_get
+
+ Consumer side, called from the main-loop only.
+
+ \param[in] None.
+
+ \return The oldest event, EVENT_NONE if the ring is empty.
+
+ */
+/* ************************************************************************** */
+
+uint8_t event_get(void);
+
+/* ************************************************************************** */
+/*!
+ \ingroup event
+
+ \brief event_pending
+
+ Consumer side, tells whether event_get() would return an event.
+
+ \param[in] None.
+
+ \return true if the ring holds an event.
+
+ */
+/* ************************************************************************** */
+
+bool event_pending(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EVENT_H_ */
@@ -0,0 +1,231 @@
+/*
+ ==============================================================================
+ Name        : led.c
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+// Compiler specific includes
+#if defined(__XC)
+#include <xc.h>        /* XC8 General Include File */
+#elif defined(HI_TECH_C)
+#include <htc.h>       /* HiTech General Include File */
+#elif defined(__18CXX)
+#include <p18cxxx.h>   /* C18 General Include File */
+#elif defined(__MINGW32__) || defined(__unix__) || defined(__APPLE__)
+#include <registers.h> /* Host Register File */
+#endif
+
+#if defined(__XC) || defined(HI_TECH_C) || defined (HOST_BUILD)
+
+#include <stdint.h>        /* For uint8_t definition */
+#include <stdbool.h>       /* For true/false definition */
+
+#endif
+
+#include <stddef.h>
+
+// CPU specific include
+#include "../pic/wake_on_sleep.X/user.h"
+
+// Project includes
+#include "sw_timer.h"
+
+// Module include
+#include "led.h"
+
+#if (LED_MODE != LED_MODE_OFF)
+
+// Local declarations
+
+// Lit and dark ticks of the heart beat
+#if (LED_MODE == LED_MODE_BENCH)
+#define LED_ON_TICKS        (LED_BENCH_USEC / USEC_PER_TICK)
+#define LED_OFF_TICKS       LED_ON_TICKS
+#elif (LED_MODE == LED_MODE_FLASH) || (LED_MODE == LED_MODE_DIM)
+#define LED_ON_TICKS        ((LED_FLASH_USEC < USEC_PER_TICK) ? 1 : \
+        (LED_FLASH_USEC / USEC_PER_TICK))
+#define LED_OFF_TICKS       ((LED_PERIOD_USEC / USEC_PER_TICK) - LED_ON_TICKS)
+#else
+#error Unknown LED_MODE.
+#endif
+
+/*
+ * A blinking LED, lit for 'on' ticks then dark for 'off' ticks.
+ */
+typedef struct _led_blink_t
+{
+    sw_timer_t timer;
+    uint16_t on;
+    uint16_t off;
+    bool lit;
+} led_blink_t, *led_blink_ptr_t;
+
+static void led_blink(led_blink_ptr_t blink, bool lit,
+        sw_timer_callback_t callback);
+static void led_show(void);
+static void led_heartbeat(void);
+#if (LED_MODE == LED_MODE_DIM)
+static void led_dim(void);
+#endif
+
+static led_blink_t led_heartbeat_blink;
+#if (LED_MODE == LED_MODE_DIM)
+static led_blink_t led_dim_blink;
+#endif
+static uint8_t led_shown; // State on the state LEDs
+
+// Implementation
+
+/*! \brief led_blink
+ *
+ * Lights or darkens a blinking LED and times the step.
+ */
+static void led_blink(led_blink_ptr_t blink, bool lit,
+        sw_timer_callback_t callback)
+{
+    blink->lit = lit;
+    sw_timer_start(&blink->timer, lit ? blink->on : blink->off,
+            SW_TIMER_ONE_SHOT, callback);
+
+    return;
+}
+
+/*! \brief led_show
+ */
+static void led_show(void)
+{
+    uint8_t bits;
+
+    if (led_heartbeat_blink.lit)
+    {
+        HEARTBEAT_PORT |= HEARTBEAT;
+    }
+    else
+    {
+        HEARTBEAT_PORT &= ~HEARTBEAT;
+    }
+
+#if (LED_MODE == LED_MODE_FLASH)
+    bits = led_heartbeat_blink.lit ? led_shown : 0;
+#elif (LED_MODE == LED_MODE_DIM)
+    bits = led_dim_blink.lit ? led_shown : 0;
+#else
+    bits = led_shown;
+#endif
+
+    // Clear and set state bits
+    STATE_PORT &= ~STATE_MASK;
+    STATE_PORT |= ((bits << STATE_BITS_SHIFT) & STATE_MASK);
+
+    return;
+}
+
+/*! \brief led_heartbeat
+ */
+static void led_heartbeat(void)
+{
+    led_blink(&led_heartbeat_blink, !led_heartbeat_blink.lit, led_heartbeat);
+
+    return;
+}
+
+#if (LED_MODE == LED_MODE_DIM)
+
+/*! \brief led_dim
+ */
+static void led_dim(void)
+{
+    led_blink(&led_dim_blink, !led_dim_blink.lit, led_dim);
+
+    return;
+}
+
+#endif
+
+/*! \brief led_init
+ */
+void led_init(void)
+{
+    led_shown = 0;
+
+    led_heartbeat_blink.on = LED_ON_TICKS;
+    led_heartbeat_blink.off = LED_OFF_TICKS;
+    led_blink(&led_heartbeat_blink, true, led_heartbeat);
+
+#if (LED_MODE == LED_MODE_DIM)
+    led_dim_blink.on = 1;
+    led_dim_blink.off = LED_DIM_TICKS - 1;
+    led_blink(&led_dim_blink, true, led_dim);
+#endif
+
+    return;
+}
+
+/*! \brief led_state
+ */
+void led_state(uint8_t state)
+{
+    // Show a new state at once
+    if (state != led_shown)
+    {
+        led_shown = state;
+        led_blink(&led_heartbeat_blink, true, led_heartbeat);
+    }
+
+    led_show();
+
+    return;
+}
+
+/*! \brief led_off
+ */
+void led_off(void)
+{
+    HEARTBEAT_PORT &= ~HEARTBEAT;
+    STATE_PORT &= ~STATE_MASK;
+
+    return;
+}
+
+#endif
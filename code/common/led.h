@@ -0,0 +1,163 @@
+/*
+ ==============================================================================
+ Name        : led.h
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+#ifndef LED_H_
+#define LED_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************** */
+/*!
+ \defgroup led
+
+ \brief These APIs and definitions are for the LED pattern engine.
+
+ The heart beat and state LEDs (SB1:SB0) are timed with software timers,
+ select how they show with LED_MODE:
+
+ LED_MODE_OFF - production, the indicators are never lit.
+ LED_MODE_FLASH - the heart beat flashes for LED_FLASH_USEC every
+ LED_PERIOD_USEC, the state LEDs show the state during the flash only.
+ LED_MODE_DIM - the heart beat flashes, the state LEDs are lit one tick in
+ LED_DIM_TICKS. The tick is slow, expect them to flicker.
+ LED_MODE_BENCH - the heart beat toggles every 200 msec and the state
+ LEDs are steady, as on the bench before. Half the awake time is lit.
+
+ A state change restarts the period, so the new state flashes at once.
+ The LEDs are all turned off before the core sleeps in the sleep state.
+ The sleep state is 0, it shows as the heart beat alone.
+ */
+/* ************************************************************************** */
+
+// LED modes, select one with LED_MODE
+#define LED_MODE_OFF    (0) // No indicators
+#define LED_MODE_FLASH  (1) // Short flash per period, state shown with it
+#define LED_MODE_DIM    (2) // Short flash, state LEDs dimmed
+#define LED_MODE_BENCH  (3) // 50% heart beat, steady state LEDs
+
+#ifndef LED_MODE
+#define LED_MODE        LED_MODE_FLASH
+#endif
+
+// Flash length and period, a flash is at least one tick
+#ifndef LED_FLASH_USEC
+#define LED_FLASH_USEC  (10000) // 10 msec
+#endif
+#ifndef LED_PERIOD_USEC
+#define LED_PERIOD_USEC (4000000) // 4 sec
+#endif
+
+// Dimmed state LEDs, lit one tick in LED_DIM_TICKS
+#ifndef LED_DIM_TICKS
+#define LED_DIM_TICKS   (4)
+#endif
+
+// Bench heart beat, toggles every LED_BENCH_USEC
+#define LED_BENCH_USEC  (200000) // 200 msec
+
+/* ************************************************************************** */
+/*!
+ \ingroup led
+
+ \brief led_init
+
+ Starts the patterns, after sw_timer_init(). The LEDs are lit by the
+ first led_state().
+
+ \param[in] None.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void led_init(void);
+
+/* ************************************************************************** */
+/*!
+ \ingroup led
+
+ \brief led_state
+
+ Drives the state LEDs for the current pattern step, a new state restarts
+ the period. Called after every run of the controller.
+
+ \param[in] state - controller state, shown on SB1:SB0.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void led_state(uint8_t state);
+
+/* ************************************************************************** */
+/*!
+ \ingroup led
+
+ \brief led_off
+
+ Turns all the LEDs off, before the core sleeps. The next led_state()
+ lights them again.
+
+ \param[in] None.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void led_off(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LED_H_ */
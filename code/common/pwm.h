@@ -60,6 +60,56 @@ extern "C"
  */
 /* ************************************************************************** */
 
+// Rated frequency of the buzzer, where its output peaks. CUI CEM-1203(42):
+// 2048 Hz square wave at 1/2 duty, 35 mA max. at 3.5 V (see datasheets).
+#define PWM_FREQ_RATED  (2048)
+
+// Tone pitches, the Timer2 setup of each is built per clock level (clock.c)
+#define PWM_PITCH_LOW   (0)
+#define PWM_PITCH_MID   (1) // The rated frequency
+#define PWM_PITCH_HIGH  (2)
+#define PWM_PITCH_TOP   (3)
+#define PWM_NUM_PITCHES (4)
+
+// Tone plans, the frequency of each pitch. Select one with PWM_PLAN.
+#define PWM_PLAN_SCALE      (0) // Octave below and above, fourth above
+#define PWM_PLAN_RESONANT   (1) // All within 20% of rated, for warbles
+
+#ifndef PWM_PLAN
+#define PWM_PLAN        PWM_PLAN_SCALE
+#endif
+
+#if (PWM_PLAN == PWM_PLAN_SCALE)
+#define PWM_FREQ_LOW    (PWM_FREQ_RATED / 2) // 1.024 kHz
+#define PWM_FREQ_MID    (PWM_FREQ_RATED) // 2.048 kHz
+#define PWM_FREQ_HIGH   ((PWM_FREQ_RATED * 4) / 3) // 2.731 kHz
+#define PWM_FREQ_TOP    (PWM_FREQ_RATED * 2) // 4.096 kHz
+#elif (PWM_PLAN == PWM_PLAN_RESONANT)
+#define PWM_FREQ_LOW    ((PWM_FREQ_RATED * 9) / 10) // 1.843 kHz
+#define PWM_FREQ_MID    (PWM_FREQ_RATED) // 2.048 kHz
+#define PWM_FREQ_HIGH   ((PWM_FREQ_RATED * 11) / 10) // 2.253 kHz
+#define PWM_FREQ_TOP    ((PWM_FREQ_RATED * 6) / 5) // 2.458 kHz
+#else
+#error Unknown PWM_PLAN.
+#endif
+
+// Duty cycle in sixteenths of the period. The rated drive is 1/2, less is
+// quieter and draws less coil current. Select the default with PWM_DUTY.
+#define PWM_DUTY_MIN    (1)
+#define PWM_DUTY_MAX    (8)
+
+#ifndef PWM_DUTY
+#define PWM_DUTY        PWM_DUTY_MAX
+#endif
+
+#define PWM_FREQ        PWM_FREQ_MID // Until pwm_pitch() picks another
+
+// Dead band between the complementary outputs (PWM_DRIVE_HALF, see user.h),
+// rounded up to whole instruction cycles at each clock level
+#ifndef PWM_DEAD_USEC
+#define PWM_DEAD_USEC   (2)
+#endif
+
 /* ************************************************************************** */
 /*!
  \ingroup pwm
@@ -94,13 +144,51 @@ void pwm_init(void);
 
 void pwm_start(void);
 
+/* ************************************************************************** */
+/*!
+ \ingroup pwm
+
+ \brief pwm_pitch
+
+ Selects the pitch of the tone, it holds across clock level switches.
+ A running tone changes pitch at once.
+
+ \param[in] pitch - PWM_PITCH_LOW, _MID, _HIGH or _TOP.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void pwm_pitch(uint8_t pitch);
+
+/* ************************************************************************** */
+/*!
+ \ingroup pwm
+
+ \brief pwm_volume
+
+ Sets the duty cycle of the tone, it holds across pitch and clock level
+ changes. A running tone changes at the next period.
+
+ \param[in] duty - sixteenths of the period, PWM_DUTY_MIN to PWM_DUTY_MAX.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void pwm_volume(uint8_t duty);
+
 /* ************************************************************************** */
 /*!
  \ingroup pwm
 
  \brief pwm_stop
 
- Stops the PWM peripheral.
+ Stops the PWM peripheral without waiting. The output is muted at once and
+ ends low at the next period boundary; pwm_service() turns the peripheral off
+ once it has if that has not happened yet.
 
  \param[in] None.
 
@@ -111,6 +199,42 @@ void pwm_start(void);
 
 void pwm_stop(void);
 
+/* ************************************************************************** */
+/*!
+ \ingroup pwm
+
+ \brief pwm_service
+
+ Finishes a pending stop. Called on EVENT_PWM, posted at the end of the
+ muted period, and on each tick in case that event was dropped.
+
+ \param[in] None.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void pwm_service(void);
+
+/* ************************************************************************** */
+/*!
+ \ingroup pwm
+
+ \brief pwm_duty
+
+ Loads the duty cycle (see pwm_volume()) for the current period, or keeps
+ the output muted while a stop is pending.
+
+ \param[in] None.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void pwm_duty(void);
+
 /* ************************************************************************** */
 /*!
  \ingroup pwm
@@ -0,0 +1,269 @@
+/*
+ ==============================================================================
+ Name        : sw_timer.c
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+// Compiler specific includes
+#if defined(__XC)
+#include <xc.h>        /* XC8 General Include File */
+#elif defined(HI_TECH_C)
+#include <htc.h>       /* HiTech General Include File */
+#elif defined(__18CXX)
+#include <p18cxxx.h>   /* C18 General Include File */
+#elif defined(__MINGW32__) || defined(__unix__) || defined(__APPLE__)
+#include <registers.h> /* Host Register File */
+#endif
+
+#if defined(__XC) || defined(HI_TECH_C) || defined (HOST_BUILD)
+
+#include <stdint.h>        /* For uint8_t definition */
+#include <stdbool.h>       /* For true/false definition */
+
+#endif
+
+#include <stddef.h>
+
+// Module include
+#include "sw_timer.h"
+
+// Local declarations
+
+static void sw_timer_insert(sw_timer_ptr_t timer, uint16_t ticks);
+static bool sw_timer_remove(sw_timer_ptr_t timer);
+
+// Head of the delta-sorted timer list
+static sw_timer_ptr_t sw_timer_head;
+
+// Implementation
+
+/*! \brief sw_timer_insert
+ */
+static void sw_timer_insert(sw_timer_ptr_t timer, uint16_t ticks)
+{
+    sw_timer_ptr_t * link = &sw_timer_head;
+
+    // Find the position, consuming the deltas of earlier timers. Timers
+    // due at the same tick keep the order in which they were started.
+    while ((*link != NULL) && ((*link)->delta <= ticks))
+    {
+        ticks -= (*link)->delta;
+        link = &(*link)->next;
+    }
+
+    // Link in, the following timer is now relative to this one
+    timer->delta = ticks;
+    timer->next = *link;
+    if (timer->next != NULL)
+    {
+        timer->next->delta -= ticks;
+    }
+    *link = timer;
+
+    return;
+}
+
+/*! \brief sw_timer_remove
+ */
+static bool sw_timer_remove(sw_timer_ptr_t timer)
+{
+    bool removed = false;
+    sw_timer_ptr_t * link = &sw_timer_head;
+
+    while ((*link != NULL) && (*link != timer))
+    {
+        link = &(*link)->next;
+    }
+
+    if (*link != NULL)
+    {
+        // Hand the remaining delta on to the following timer
+        if (timer->next != NULL)
+        {
+            timer->next->delta += timer->delta;
+        }
+        *link = timer->next;
+        removed = true;
+    }
+
+    return removed;
+}
+
+/*! \brief sw_timer_init
+ */
+void sw_timer_init(void)
+{
+    sw_timer_head = NULL;
+
+    return;
+}
+
+/*! \brief sw_timer_start
+ */
+void sw_timer_start(sw_timer_ptr_t timer, uint16_t ticks, uint16_t period,
+        sw_timer_callback_t callback)
+{
+    // Restart if already running
+    sw_timer_remove(timer);
+
+    // A timer expires on a tick, never before the next one. A zero delta
+    // head would expire without a decrement and delay the timers behind.
+    if (ticks == 0)
+    {
+        ticks = 1;
+    }
+
+    timer->period = period;
+    timer->callback = callback;
+    timer->expired = false;
+
+    sw_timer_insert(timer, ticks);
+
+    return;
+}
+
+/*! \brief sw_timer_stop
+ */
+void sw_timer_stop(sw_timer_ptr_t timer)
+{
+    sw_timer_remove(timer);
+    timer->expired = false;
+
+    return;
+}
+
+/*! \brief sw_timer_expired
+ */
+bool sw_timer_expired(sw_timer_ptr_t timer)
+{
+    bool expired = timer->expired;
+
+    timer->expired = false;
+
+    return expired;
+}
+
+/*! \brief sw_timer_remaining
+ */
+uint16_t sw_timer_remaining(sw_timer_ptr_t timer)
+{
+    uint16_t ticks = 0;
+    sw_timer_ptr_t entry = sw_timer_head;
+
+    while ((entry != NULL) && (entry != timer))
+    {
+        ticks += entry->delta;
+        entry = entry->next;
+    }
+
+    return ((entry != NULL) ? (ticks + entry->delta) : 0);
+}
+
+/*! \brief sw_timer_next
+ */
+uint16_t sw_timer_next(void)
+{
+    return ((sw_timer_head != NULL) ? sw_timer_head->delta : SW_TIMER_NONE);
+}
+
+/*! \brief sw_timer_skip
+ */
+void sw_timer_skip(uint16_t ticks)
+{
+    sw_timer_ptr_t timer = sw_timer_head;
+
+    // Only the head entry counts down, never past its last tick
+    if ((timer != NULL) && (timer->delta > 1))
+    {
+        if (ticks >= timer->delta)
+        {
+            ticks = timer->delta - 1;
+        }
+        timer->delta -= ticks;
+    }
+
+    return;
+}
+
+/*! \brief sw_timer_tick
+ */
+void sw_timer_tick(void)
+{
+    sw_timer_ptr_t timer = sw_timer_head;
+
+    if (timer == NULL)
+    {
+        return;
+    }
+
+    // Only the head entry counts down
+    if (timer->delta > 0)
+    {
+        --timer->delta;
+    }
+
+    // Expire everything that is due
+    while ((timer != NULL) && (timer->delta == 0))
+    {
+        sw_timer_head = timer->next;
+
+        timer->expired = true;
+
+        // Periodic timers are put back before the callback runs, so the
+        // callback may stop or restart them.
+        if (timer->period != SW_TIMER_ONE_SHOT)
+        {
+            sw_timer_insert(timer, timer->period);
+        }
+
+        if (timer->callback != NULL)
+        {
+            timer->callback();
+        }
+
+        timer = sw_timer_head;
+    }
+
+    return;
+}
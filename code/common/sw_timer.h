@@ -0,0 +1,243 @@
+/*
+ ==============================================================================
+ Name        : sw_timer.h
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+#ifndef SW_TIMER_H_
+#define SW_TIMER_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************** */
+/*!
+ \defgroup sw_timer
+
+ \brief These APIs and definitions are for the software timer module.
+
+ Timers are kept in a delta-sorted list, each entry holding the number of
+ ticks after the entry before it. A tick therefore only decrements the head
+ entry regardless of how many timers are running. Timer storage is owned by
+ the caller and must stay valid while the timer is running.
+ */
+/* ************************************************************************** */
+
+// Returned by sw_timer_next() when no timer is running
+#define SW_TIMER_NONE (0xFFFF)
+
+// Period of a one-shot timer
+#define SW_TIMER_ONE_SHOT (0)
+
+/*
+ * Software timer expiry callback.
+ */
+typedef void (*sw_timer_callback_t)(void);
+
+/*
+ * Software timer definition.
+ */
+typedef struct _sw_timer_t
+{
+    struct _sw_timer_t * next;
+    uint16_t delta; // ticks after the previous timer in the list
+    uint16_t period; // reload ticks, SW_TIMER_ONE_SHOT if not periodic
+    sw_timer_callback_t callback; // may be NULL
+    bool expired;
+} sw_timer_t, *sw_timer_ptr_t;
+
+/* ************************************************************************** */
+/*!
+ \ingroup sw_timer
+
+ \brief sw_timer_init
+
+ Initializes the software timer module, no timers are running.
+
+ \param[in] None.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void sw_timer_init(void);
+
+/* ************************************************************************** */
+/*!
+ \ingroup sw_timer
+
+ \brief sw_timer_start
+
+ Starts (or restarts) a timer. The timer expires after 'ticks' ticks and
+ then every 'period' ticks unless the period is SW_TIMER_ONE_SHOT. On expiry
+ the expired flag is set and the callback, if any, is called. A count of 0
+ is taken as 1, the timer expires on the next tick.
+
+ \param[in] timer - timer to start.
+ \param[in] ticks - ticks until the first expiry, at least 1.
+ \param[in] period - reload ticks or SW_TIMER_ONE_SHOT.
+ \param[in] callback - expiry callback or NULL.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void sw_timer_start(sw_timer_ptr_t timer, uint16_t ticks, uint16_t period,
+        sw_timer_callback_t callback);
+
+/* ************************************************************************** */
+/*!
+ \ingroup sw_timer
+
+ \brief sw_timer_stop
+
+ Stops a timer and clears its expired flag. Stopping a timer which is not
+ running has no effect.
+
+ \param[in] timer - timer to stop.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void sw_timer_stop(sw_timer_ptr_t timer);
+
+/* ************************************************************************** */
+/*!
+ \ingroup sw_timer
+
+ \brief sw_timer_expired
+
+ Tests and clears the expired flag of a timer.
+
+ \param[in] timer - timer to test.
+
+ \return bool - true if the timer expired since the last call.
+
+ */
+/* ************************************************************************** */
+
+bool sw_timer_expired(sw_timer_ptr_t timer);
+
+/* ************************************************************************** */
+/*!
+ \ingroup sw_timer
+
+ \brief sw_timer_remaining
+
+ Determines the number of ticks until a timer expires.
+
+ \param[in] timer - timer to query.
+
+ \return uint16_t - ticks remaining, 0 if the timer is not running.
+
+ */
+/* ************************************************************************** */
+
+uint16_t sw_timer_remaining(sw_timer_ptr_t timer);
+
+/* ************************************************************************** */
+/*!
+ \ingroup sw_timer
+
+ \brief sw_timer_next
+
+ Determines the number of ticks until the next timer expires.
+
+ \param[in] None.
+
+ \return uint16_t - ticks until the next deadline or SW_TIMER_NONE.
+
+ */
+/* ************************************************************************** */
+
+uint16_t sw_timer_next(void);
+
+/* ************************************************************************** */
+/*!
+ \ingroup sw_timer
+
+ \brief sw_timer_skip
+
+ Advances the software timers by a number of ticks in which none of them
+ expires, for a caller that skipped over idle ticks. The count is limited
+ to one tick less than sw_timer_next().
+
+ \param[in] ticks - ticks to skip.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void sw_timer_skip(uint16_t ticks);
+
+/* ************************************************************************** */
+/*!
+ \ingroup sw_timer
+
+ \brief sw_timer_tick
+
+ Advances the software timers by one tick, expiring any that are due.
+ Called once per main-loop tick.
+
+ \param[in] None.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void sw_timer_tick(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SW_TIMER_H_ */
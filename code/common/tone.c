@@ -0,0 +1,206 @@
+/*
+ ==============================================================================
+ Name        : tone.c
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+// Compiler specific includes
+#if defined(__XC)
+#include <xc.h>        /* XC8 General Include File */
+#elif defined(HI_TECH_C)
+#include <htc.h>       /* HiTech General Include File */
+#elif defined(__18CXX)
+#include <p18cxxx.h>   /* C18 General Include File */
+#elif defined(__MINGW32__) || defined(__unix__) || defined(__APPLE__)
+#include <registers.h> /* Host Register File */
+#endif
+
+#if defined(__XC) || defined(HI_TECH_C) || defined (HOST_BUILD)
+
+#include <stdint.h>        /* For uint8_t definition */
+#include <stdbool.h>       /* For true/false definition */
+
+#endif
+
+// CPU specific include
+#include "../pic/wake_on_sleep.X/user.h"
+
+// Project includes
+#include "pwm.h"
+
+// Module include
+#include "tone.h"
+
+// Local declarations
+
+static void tone_stage(tone_ptr_t tone, uint8_t stage);
+
+/*
+ * Sequences.
+ */
+
+// Three short beeps
+const uint8_t tone_announce[] =
+{ TONE_PLAY(PWM_PITCH_MID, 125), TONE_REST(125), TONE_REPEAT(1),
+        TONE_PLAY(PWM_PITCH_MID, 125), TONE_END };
+
+// Beeps at 1 Hz, at 2 Hz for the last 3 seconds, then a steady tone
+const uint8_t tone_alert[] =
+{ TONE_PLAY(PWM_PITCH_MID, 250), TONE_REST(750), TONE_LOOP,
+        TONE_STAGE(3), TONE_PLAY(PWM_PITCH_MID, 250), TONE_REST(250), TONE_LOOP,
+        TONE_STAGE(1), TONE_HOLD(PWM_PITCH_MID), TONE_END };
+
+// As the alert with a quarter of the on-time, and beeps to the end
+const uint8_t tone_alert_low[] =
+{ TONE_PLAY(PWM_PITCH_MID, 60), TONE_REST(940), TONE_LOOP,
+        TONE_STAGE(3), TONE_PLAY(PWM_PITCH_MID, 60), TONE_REST(440), TONE_LOOP,
+        TONE_STAGE(1), TONE_PLAY(PWM_PITCH_MID, 60), TONE_REST(190), TONE_LOOP,
+        TONE_END };
+
+// Implementation
+
+/*! \brief tone_stage
+ *
+ * Enters the stage whose first step is at 'stage', and finds the stage
+ * after it. Every sequence ends with TONE_END, the search stops there.
+ */
+static void tone_stage(tone_ptr_t tone, uint8_t stage)
+{
+    uint8_t op;
+    uint8_t step = stage;
+
+    tone->step = stage;
+    tone->stage = stage;
+    tone->repeat = 0;
+    tone->next = 0;
+
+    do
+    {
+        op = tone->sequence[step] & TONE_OP_MASK;
+        if (op == TONE_OP_STAGE)
+        {
+            tone->next = step;
+        }
+        step += 2;
+    } while ((op != TONE_OP_STAGE) && (op != TONE_OP_END));
+
+    return;
+}
+
+/*! \brief tone_start
+ */
+void tone_start(tone_ptr_t tone, uint8_t const * sequence)
+{
+    // Each sequence starts at the default volume
+    pwm_volume(PWM_DUTY);
+
+    tone->sequence = sequence;
+    tone_stage(tone, 0);
+
+    return;
+}
+
+/*! \brief tone_step
+ */
+uint8_t tone_step(tone_ptr_t tone, uint8_t left)
+{
+    uint8_t op;
+    uint8_t arg;
+
+    // The next stage takes over at a step boundary
+    if ((tone->next != 0) && (left <= tone->sequence[tone->next + 1]))
+    {
+        tone_stage(tone, tone->next + 2);
+    }
+
+    do
+    {
+        op = tone->sequence[tone->step];
+        arg = tone->sequence[tone->step + 1];
+        tone->step += 2;
+
+        switch (op & TONE_OP_MASK)
+        {
+        case TONE_OP_PLAY:
+            pwm_pitch(op & ~TONE_OP_MASK);
+            pwm_start();
+            return arg;
+
+        case TONE_OP_REST:
+            pwm_stop();
+            return arg;
+
+        case TONE_OP_REPEAT:
+            // The first pass loads the count
+            if (tone->repeat == 0)
+            {
+                tone->repeat = arg + 1;
+            }
+            if (--tone->repeat != 0)
+            {
+                tone->step = tone->stage;
+            }
+            break;
+
+        case TONE_OP_LOOP:
+            tone->step = tone->stage;
+            break;
+
+        case TONE_OP_VOLUME:
+            pwm_volume(arg);
+            break;
+
+        case TONE_OP_STAGE:
+            // Run into, it starts now
+            tone_stage(tone, tone->step);
+            break;
+
+        default:
+            // TONE_OP_END, stay on it
+            tone->step -= 2;
+            pwm_stop();
+            return 0;
+        }
+    } while (true);
+}
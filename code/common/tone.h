@@ -0,0 +1,169 @@
+/*
+ ==============================================================================
+ Name        : tone.h
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+#ifndef TONE_H_
+#define TONE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************** */
+/*!
+ \defgroup tone
+
+ \brief These APIs and definitions are for the tone sequence player.
+
+ A sequence is a const byte array of two-byte steps, built with the macros
+ below, and ends with TONE_END. It is split into stages. A stage runs its steps and may loop back
+ to its own start, and it gives way to the next stage once the caller has
+ no more seconds left than that stage's TONE_STAGE value. The player only
+ drives the PWM module. The caller times each step with a software timer.
+ A loop must pass a step with ticks, or tone_step() never returns.
+
+ Example, beep at 1 Hz, then at 2 Hz for the last 3 seconds:
+
+   TONE_PLAY(PWM_PITCH_MID, 250), TONE_REST(750), TONE_LOOP,
+   TONE_STAGE(3), TONE_PLAY(PWM_PITCH_MID, 250), TONE_REST(250), TONE_LOOP,
+   TONE_END
+ */
+/* ************************************************************************** */
+
+// Step opcodes, the low nibble of TONE_OP_PLAY holds the pitch
+#define TONE_OP_MASK    (0xF0)
+#define TONE_OP_PLAY    (0x00) // Sound a pitch for a number of ticks
+#define TONE_OP_REST    (0x10) // Silence for a number of ticks
+#define TONE_OP_REPEAT  (0x20) // Back to the stage start, a number of times
+#define TONE_OP_LOOP    (0x30) // Back to the stage start
+#define TONE_OP_STAGE   (0x40) // Stage start, and when it takes over
+#define TONE_OP_END     (0x50) // Silence, the sequence is over
+#define TONE_OP_VOLUME  (0x60) // Duty cycle of the following steps
+
+// Ticks of a step, 1 to 255: 2.55 s at a 10 ms tick, 2.04 s at 8 ms. A
+// step out of range fails to compile (the sizeof of a negative array)
+// rather than wrap in the uint8_t.
+#define TONE_TICKS_ANY(msec) (((uint32_t) (msec) * 1000) / USEC_PER_TICK)
+#define TONE_TICKS(msec) \
+    ((uint8_t) (TONE_TICKS_ANY(msec) + 0 * sizeof (char[ \
+    ((TONE_TICKS_ANY(msec) >= 1) && (TONE_TICKS_ANY(msec) <= 255)) ? 1 : -1])))
+
+// Steps
+#define TONE_PLAY(pitch, msec)  (TONE_OP_PLAY | (pitch)), TONE_TICKS(msec)
+#define TONE_HOLD(pitch)        (TONE_OP_PLAY | (pitch)), 0 // Until stopped
+#define TONE_REST(msec)         TONE_OP_REST, TONE_TICKS(msec)
+#define TONE_REPEAT(times)      TONE_OP_REPEAT, (times) // 1 to 255 more
+#define TONE_LOOP               TONE_OP_LOOP, 0
+#define TONE_STAGE(seconds)     TONE_OP_STAGE, (seconds)
+#define TONE_END                TONE_OP_END, 0
+#define TONE_VOLUME(duty)       TONE_OP_VOLUME, (duty) // See pwm_volume()
+
+// Seconds left when there is no deadline, no stage takes over early
+#define TONE_NO_DEADLINE (0xFF)
+
+/*
+ * Player state, owned by the caller.
+ */
+typedef struct _tone_t
+{
+    uint8_t const * sequence;
+    uint8_t step; // Offset of the next step
+    uint8_t stage; // Offset of the first step of the stage
+    uint8_t next; // Offset of the next TONE_STAGE, 0 if none
+    uint8_t repeat; // TONE_REPEAT passes left, 0 if not repeating
+} tone_t, *tone_ptr_t;
+
+// Sequences
+extern const uint8_t tone_announce[]; // Power-on "ready"
+extern const uint8_t tone_alert[]; // Inactivity alert
+extern const uint8_t tone_alert_low[]; // Inactivity alert, low battery
+
+/* ************************************************************************** */
+/*!
+ \ingroup tone
+
+ \brief tone_start
+
+ Loads a sequence at the PWM_DUTY volume, tone_step() plays its first
+ step.
+
+ \param[in] tone - player state.
+ \param[in] sequence - sequence to play.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void tone_start(tone_ptr_t tone, uint8_t const * sequence);
+
+/* ************************************************************************** */
+/*!
+ \ingroup tone
+
+ \brief tone_step
+
+ Plays the next step. Called on start and whenever the last step's ticks
+ are up. Moves on to the next stage first if it is due.
+
+ \param[in] tone - player state.
+ \param[in] left - seconds left to the caller's deadline, or
+ TONE_NO_DEADLINE.
+
+ \return Ticks of the step, 0 when the sound holds until the caller stops
+ it or the sequence has ended.
+
+ */
+/* ************************************************************************** */
+
+uint8_t tone_step(tone_ptr_t tone, uint8_t left);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TONE_H_ */
@@ -0,0 +1,495 @@
+/*
+ ==============================================================================
+ Name        : usage.c
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+// Compiler specific includes
+#if defined(__XC)
+#include <xc.h>        /* XC8 General Include File */
+#elif defined(HI_TECH_C)
+#include <htc.h>       /* HiTech General Include File */
+#elif defined(__18CXX)
+#include <p18cxxx.h>   /* C18 General Include File */
+#elif defined(__MINGW32__) || defined(__unix__) || defined(__APPLE__)
+#include <registers.h> /* Host Register File */
+#endif
+
+#if defined(__XC) || defined(HI_TECH_C) || defined (HOST_BUILD)
+
+#include <stdint.h>        /* For uint8_t definition */
+#include <stdbool.h>       /* For true/false definition */
+
+#endif
+
+#include <stddef.h>
+
+#if defined (USAGE_LOG)
+
+// CPU specific include
+#include "../pic/wake_on_sleep.X/user.h"
+
+// Module include
+#include "usage.h"
+
+// Local declarations
+
+#if (__18F45K20 == 1) || (_18F45K20 == 1)
+
+// Watchdog period set by WDTPS in the configuration bits, 4 msec * 32768
+#define USAGE_WDT_SECONDS   (131)
+#define USAGE_TIMED_OUT     (RCONbits.nTO == 0)
+#define USAGE_POWER_ON      (RCONbits.nPOR == 0)
+#define USAGE_POWER_ON_ACK  (RCONbits.nPOR = 1)
+
+#elif (__16F1823 == 1) || (_16F1823 == 1)
+
+// Watchdog 1:1048576 while asleep (32 sec nominal), see WDTCON (WDTPS)
+#define USAGE_WDT_PRESCALE  (0b01111)
+#define USAGE_WDT_SECONDS   (32)
+#define USAGE_TIMED_OUT     (STATUSbits.nTO == 0)
+#define USAGE_POWER_ON      (PCONbits.nPOR == 0)
+#define USAGE_POWER_ON_ACK  (PCONbits.nPOR = 1)
+
+#elif defined HOST_BUILD
+
+#error USAGE_LOG writes the data EEPROM, build it for a target.
+
+#else
+
+#error Error! You must create definitions for this processor.
+
+#endif
+
+#define USAGE_TICKS_PER_SEC (1000000L / USEC_PER_TICK)
+#define USAGE_SEQ_NONE      (0xFF)
+
+// Records one wake-up logs, EXTEND, to alert, the outcome, back to sleep
+#define USAGE_WAKE_RECORDS  (4)
+
+#if (USAGE_LOG_BATCH < USAGE_WAKE_RECORDS)
+#error USAGE_LOG_BATCH must hold the records of a wake-up.
+#endif
+
+/*
+ * 26 bytes of RAM with the default batch. The totals are only in the data
+ * EEPROM, RAM holds what has been counted since the last checkpoint.
+ */
+static uint16_t usage_buffer[USAGE_LOG_BATCH]; // Records, lap bit clear
+static uint16_t usage_seconds[USAGE_STATES]; // Residency to add
+static uint8_t usage_alerts[2]; // Outcomes to add, USAGE_ALERT_...
+static uint8_t usage_count; // Records in the buffer
+static uint8_t usage_head; // Next ring record to write
+static uint8_t usage_lap; // Lap bit of this lap, in byte 1
+static uint8_t usage_copy; // Copy holding the newest totals
+static uint8_t usage_seq; // Its sequence number
+static uint8_t usage_ticks; // Ticks into the current second
+static uint32_t usage_since; // Seconds since the last record
+
+static uint8_t usage_next_seq(uint8_t seq);
+static uint8_t usage_lap_of(uint8_t record);
+static uint32_t usage_read(uint8_t address, uint8_t size);
+static void usage_write(uint8_t address, uint32_t value, uint8_t size);
+static void usage_checkpoint(void);
+static void usage_count_seconds(uint8_t state, uint16_t seconds);
+static void usage_push(uint16_t record);
+static void usage_record(uint8_t kind, uint8_t arg);
+static void usage_flush(void);
+
+// Implementation
+
+/*! \brief usage_next_seq
+ */
+static uint8_t usage_next_seq(uint8_t seq)
+{
+    return (seq >= (USAGE_SEQ_NONE - 1)) ? 0 : (uint8_t) (seq + 1);
+}
+
+/*! \brief usage_lap_of
+ *
+ * Lap bit of a ring record, in its second byte.
+ */
+static uint8_t usage_lap_of(uint8_t record)
+{
+    return eeprom_read(USAGE_RING_BASE + (2 * record) + 1) & 0x80;
+}
+
+/*! \brief usage_read
+ *
+ * Little endian field of the newest copy, 0 before the first one.
+ */
+static uint32_t usage_read(uint8_t address, uint8_t size)
+{
+    uint32_t value = 0;
+
+    if (usage_seq != USAGE_SEQ_NONE)
+    {
+        address += usage_copy * sizeof(usage_totals_t);
+        while (size-- > 0)
+        {
+            value = (value << 8) | eeprom_read(address + size);
+        }
+    }
+
+    return value;
+}
+
+/*! \brief usage_write
+ *
+ * Little endian field of the next copy.
+ */
+static void usage_write(uint8_t address, uint32_t value, uint8_t size)
+{
+    address += ((usage_copy + 1) % USAGE_COPIES) * sizeof(usage_totals_t);
+    while (size-- > 0)
+    {
+        eeprom_write(address++, (uint8_t) value);
+        value >>= 8;
+    }
+
+    return;
+}
+
+/*! \brief usage_checkpoint
+ *
+ * Adds what was counted to the newest copy of the totals and writes the
+ * sum to the next copy, field by field.
+ */
+static void usage_checkpoint(void)
+{
+    uint32_t value;
+    uint8_t address;
+    uint8_t i;
+
+    for (i = 0; i < USAGE_STATES; i++)
+    {
+        address = offsetof(usage_totals_t, residency) + (4 * i);
+        usage_write(address, usage_read(address, 4) + usage_seconds[i], 4);
+        usage_seconds[i] = 0;
+    }
+
+    // cancelled and timed_out follow each other, in outcome order
+    for (i = 0; i < 2; i++)
+    {
+        address = offsetof(usage_totals_t, cancelled) + (2 * i);
+        value = usage_read(address, 2) + usage_alerts[i];
+        usage_write(address, (value > UINT16_MAX) ? UINT16_MAX : value, 2);
+        usage_alerts[i] = 0;
+    }
+
+    // Sequence number last, a torn copy is not the newest
+    usage_seq = usage_next_seq(usage_seq);
+    usage_write(offsetof(usage_totals_t, seq), usage_seq, 1);
+    usage_copy = (usage_copy + 1) % USAGE_COPIES;
+
+    return;
+}
+
+/*! \brief usage_count_seconds
+ *
+ * A count that would overflow is checkpointed first, about every 18 hours
+ * of one state.
+ */
+static void usage_count_seconds(uint8_t state, uint16_t seconds)
+{
+    if (usage_seconds[state] > (UINT16_MAX - seconds))
+    {
+        usage_checkpoint();
+    }
+    usage_seconds[state] += seconds;
+    usage_since += seconds;
+
+    return;
+}
+
+/*! \brief usage_push
+ *
+ * Buffers a record, a full buffer is written out at once.
+ */
+static void usage_push(uint16_t record)
+{
+    if (usage_count >= USAGE_LOG_BATCH)
+    {
+        usage_flush();
+    }
+    usage_buffer[usage_count++] = record;
+
+    return;
+}
+
+/*! \brief usage_record
+ *
+ * Buffers a record of the time since the previous one, preceded by
+ * EXTEND records for what does not fit its delta.
+ */
+static void usage_record(uint8_t kind, uint8_t arg)
+{
+    uint32_t extend;
+
+    while (usage_since > USAGE_DELTA_MAX)
+    {
+        extend = usage_since >> USAGE_DELTA_BITS;
+        if (extend > USAGE_DELTA_MAX)
+        {
+            extend = USAGE_DELTA_MAX;
+        }
+        usage_push(USAGE_RECORD(USAGE_KIND_EXTEND, 0, extend));
+        usage_since -= extend << USAGE_DELTA_BITS;
+    }
+    usage_push(USAGE_RECORD(kind, arg, usage_since));
+
+    usage_since = 0;
+
+    return;
+}
+
+/*! \brief usage_flush
+ *
+ * Writes the buffered records to the ring, then checkpoints the totals.
+ * eeprom_write() waits for the previous write.
+ */
+static void usage_flush(void)
+{
+    uint8_t address;
+    uint8_t i;
+
+    for (i = 0; i < usage_count; i++)
+    {
+        address = USAGE_RING_BASE + (2 * usage_head);
+        eeprom_write(address, LOW_BYTE(usage_buffer[i]));
+        eeprom_write(address + 1, HIGH_BYTE(usage_buffer[i]) | usage_lap);
+
+        if (++usage_head >= USAGE_RING_RECORDS)
+        {
+            usage_head = 0;
+            usage_lap ^= HIGH_BYTE(USAGE_LAP);
+        }
+    }
+    usage_count = 0;
+
+    usage_checkpoint();
+
+    return;
+}
+
+/*! \brief usage_init
+ */
+void usage_init(void)
+{
+    uint8_t seq[USAGE_COPIES];
+    uint8_t copy;
+    uint8_t next;
+    uint8_t lap;
+    uint8_t i;
+
+    // Newest copy, the one a copy with the next sequence number does not
+    // follow. None before the first batch, which goes to copy 0 with
+    // sequence number 0.
+    usage_copy = USAGE_COPIES - 1;
+    usage_seq = USAGE_SEQ_NONE;
+    for (copy = 0; copy < USAGE_COPIES; copy++)
+    {
+        seq[copy] = eeprom_read((copy * sizeof(usage_totals_t))
+                + offsetof(usage_totals_t, seq));
+    }
+    for (copy = 0; copy < USAGE_COPIES; copy++)
+    {
+        next = (copy + 1) % USAGE_COPIES;
+        if ((seq[copy] != USAGE_SEQ_NONE)
+                && (seq[next] != usage_next_seq(seq[copy])))
+        {
+            usage_copy = copy;
+            usage_seq = seq[copy];
+            break;
+        }
+    }
+    for (i = 0; i < USAGE_STATES; i++)
+    {
+        usage_seconds[i] = 0;
+    }
+    usage_alerts[USAGE_ALERT_CANCELLED] = 0;
+    usage_alerts[USAGE_ALERT_TIMED_OUT] = 0;
+
+    // End of the ring, the first record whose lap differs from the first
+    // one. Without one the ring is full and the next lap starts over.
+    lap = usage_lap_of(0);
+    usage_head = 0;
+    for (i = 1; i < USAGE_RING_RECORDS; i++)
+    {
+        if (usage_lap_of(i) != lap)
+        {
+            usage_head = i;
+            break;
+        }
+    }
+    usage_lap = lap;
+    if (usage_head == 0)
+    {
+        usage_lap ^= HIGH_BYTE(USAGE_LAP);
+    }
+
+    usage_count = 0;
+    usage_ticks = 0;
+    usage_since = 0;
+
+    if (USAGE_POWER_ON)
+    {
+        USAGE_POWER_ON_ACK;
+        usage_record(USAGE_KIND_BOOT, USAGE_BOOT_POWER_ON);
+    }
+    else
+    {
+        usage_record(USAGE_KIND_BOOT, USAGE_BOOT_RESET);
+    }
+
+    return;
+}
+
+/*! \brief usage_tick
+ */
+void usage_tick(uint8_t state)
+{
+    if (state >= USAGE_STATES)
+    {
+        return;
+    }
+
+    if (++usage_ticks >= USAGE_TICKS_PER_SEC)
+    {
+        usage_ticks = 0;
+        usage_count_seconds(state, 1);
+    }
+
+    return;
+}
+
+/*! \brief usage_state
+ */
+void usage_state(uint8_t state)
+{
+    usage_record(USAGE_KIND_STATE, state);
+
+    return;
+}
+
+/*! \brief usage_alert
+ */
+void usage_alert(uint8_t outcome)
+{
+    if (usage_alerts[outcome] == UINT8_MAX)
+    {
+        usage_checkpoint();
+    }
+    usage_alerts[outcome]++;
+    usage_record(USAGE_KIND_ALERT, outcome);
+
+    return;
+}
+
+/*! \brief usage_save
+ */
+void usage_save(void)
+{
+    // Written while the next wake-up could still fit, not when it is awake
+    if (usage_count > (USAGE_LOG_BATCH - USAGE_WAKE_RECORDS))
+    {
+        usage_flush();
+    }
+
+    return;
+}
+
+/*! \brief usage_sleep
+ */
+void usage_sleep(uint8_t state)
+{
+    // A pending Timer0 interrupt would end every SLEEP() at once
+    uint8_t tmr0ie = INTCONbits.TMR0IE;
+
+    INTCONbits.TMR0IE = 0;
+    INTCONbits.TMR0IF = 0;
+
+#if (__16F1823 == 1) || (_16F1823 == 1)
+    WDTCONbits.WDTPS = USAGE_WDT_PRESCALE;
+#endif
+
+    do
+    {
+        CLRWDT();
+        WDTCONbits.SWDTEN = 1;
+        SLEEP();
+        WDTCONbits.SWDTEN = 0;
+
+        // nTO is only cleared by a watchdog time-out
+        if (USAGE_TIMED_OUT)
+        {
+            usage_count_seconds(state, USAGE_WDT_SECONDS);
+        }
+    } while (nAWAKE_FLAG == 0);
+
+    // Half of the last, partial, period
+    usage_count_seconds(state, USAGE_WDT_SECONDS / 2);
+
+#if ((__16F1823 == 1) || (_16F1823 == 1)) && (IDLE_MODE == IDLE_MODE_WDT)
+    WDTCONbits.WDTPS = WDT_PRESCALE;
+#endif
+
+    INTCONbits.TMR0IE = tmr0ie;
+
+    return;
+}
+
+/*! \brief usage_stop
+ */
+void usage_stop(void)
+{
+    if (usage_count > 0)
+    {
+        usage_flush();
+    }
+
+    return;
+}
+
+#endif
@@ -0,0 +1,270 @@
+/*
+ ==============================================================================
+ Name        : usage.h
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+#ifndef USAGE_H_
+#define USAGE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************** */
+/*!
+ \defgroup usage
+
+ \brief These APIs and definitions are for the usage log.
+
+ Built when USAGE_LOG is defined, targets only. The data EEPROM holds
+ USAGE_COPIES copies of the totals followed by a ring of two-byte
+ records. Records are kept in RAM and written in batches just before the
+ controller sleeps, the totals are checkpointed with every batch into the
+ next copy. Every ring byte is written once per lap and every copy once
+ per USAGE_COPIES batches, so the wear is spread evenly.
+
+ The totals are not kept in RAM, to fit the 16F1823: only the seconds and
+ outcomes counted since the last checkpoint are, the checkpoint adds them
+ to the newest copy as it writes the next. A batch is written when the
+ buffer could not take another wake-up, with the default USAGE_LOG_BATCH
+ that is every sleep with something logged.
+
+ A record is the time since the previous record, a kind and its argument:
+
+   byte 0: delta<7:0>
+   byte 1: lap<7> kind<6:5> arg<4:3> delta<10:8>
+
+ delta is in seconds, an EXTEND record adds its delta * 2048 seconds to
+ the next record. The lap bit flips on every lap of the ring, the oldest
+ record follows the first one whose lap differs from the one before it.
+ Byte 1 is written last, a torn record keeps the old lap. 0xFFFF (erased)
+ is never written.
+
+ Time is counted in ticks while awake. Asleep, the watchdog wakes the
+ core every USAGE_WDT_SECONDS to count, half a period is added on the
+ wake-up: the sleep time is right on average, off by up to half a period
+ each time.
+ */
+/* ************************************************************************** */
+
+// Record kinds and their arguments
+#define USAGE_KIND_STATE        (0) // Transition, arg is the new state
+#define USAGE_KIND_ALERT        (1) // Alert outcome
+#define USAGE_KIND_EXTEND       (2) // delta * 2048 seconds more
+#define USAGE_KIND_BOOT         (3) // Reset, arg is the cause
+
+#define USAGE_ALERT_CANCELLED   (0) // Motion ended the alert
+#define USAGE_ALERT_TIMED_OUT   (1) // Nobody moved
+
+#define USAGE_BOOT_POWER_ON     (0) // Cold start, the totals carry on
+#define USAGE_BOOT_RESET        (1) // MCLR, brown-out or stack
+
+// Record fields
+#define USAGE_DELTA_BITS        (11)
+#define USAGE_DELTA_MAX         ((1 << USAGE_DELTA_BITS) - 1)
+#define USAGE_RECORD(kind, arg, delta) \
+    ((uint16_t) (((uint16_t) (kind) << 13) | ((uint16_t) (arg) << 11) | \
+        (delta)))
+#define USAGE_LAP               (0x8000)
+
+// States counted, sleep, init and alert. End of life is logged, not
+// counted.
+#define USAGE_STATES            (3)
+
+// Copies of the totals, then the ring to the end of the data EEPROM
+#define USAGE_EEPROM_SIZE       (256)
+#define USAGE_COPIES            (4)
+#define USAGE_RING_BASE         (USAGE_COPIES * sizeof(usage_totals_t))
+#define USAGE_RING_RECORDS      ((USAGE_EEPROM_SIZE - USAGE_RING_BASE) / 2)
+
+// Records per batch, the size of the RAM buffer
+#ifndef USAGE_LOG_BATCH
+#define USAGE_LOG_BATCH         (4)
+#endif
+
+/*
+ * Layout of the USAGE_COPIES copies of the totals in the data EEPROM, not
+ * kept in RAM. seq is the last byte written, 0 to 254 and 0xFF for a copy
+ * never written. Read the newest copy with the programmer.
+ */
+typedef struct _usage_totals_t
+{
+    uint32_t residency[USAGE_STATES]; // seconds, by controller state
+    uint16_t cancelled; // alerts cancelled by motion, saturates
+    uint16_t timed_out; // alerts that timed out, saturates
+    uint8_t seq;
+
+} usage_totals_t, *usage_totals_ptr_t;
+
+/* ************************************************************************** */
+/*!
+ \ingroup usage
+
+ \brief usage_init
+
+ Loads the newest totals, finds the end of the ring and logs the reset.
+
+ \param[in] None.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void usage_init(void);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usage
+
+ \brief usage_tick
+
+ Counts one tick of the given state, nothing for a state not counted.
+
+ \param[in] state - controller state.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void usage_tick(uint8_t state);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usage
+
+ \brief usage_state
+
+ Logs a state transition.
+
+ \param[in] state - the new controller state.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void usage_state(uint8_t state);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usage
+
+ \brief usage_alert
+
+ Logs and counts how an alert ended.
+
+ \param[in] outcome - USAGE_ALERT_CANCELLED or USAGE_ALERT_TIMED_OUT.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void usage_alert(uint8_t outcome);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usage
+
+ \brief usage_save
+
+ Writes the batch and checkpoints the totals, if another wake-up might
+ not fit the buffer. The writes take a
+ few milliseconds each, call it before interrupts are held off to sleep.
+
+ \param[in] None.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void usage_save(void);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usage
+
+ \brief usage_sleep
+
+ Replaces SLEEP() in the sleep state. Sleeps until nAWAKE, counting
+ watchdog periods, with the Timer0 interrupt off. Called with interrupts
+ off and the nAWAKE flag cleared, after usage_save().
+
+ \param[in] state - controller state the time asleep counts for.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void usage_sleep(uint8_t state);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usage
+
+ \brief usage_stop
+
+ Writes out the buffered records and the totals, for a controller that
+ will not sleep through usage_sleep() again.
+
+ \param[in] None.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void usage_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USAGE_H_ */
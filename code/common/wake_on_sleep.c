@@ -51,9 +51,11 @@
 #include <htc.h>       /* HiTech General Include File */
 #elif defined(__18CXX)
 #include <p18cxxx.h>   /* C18 General Include File */
+#elif defined(__MINGW32__) || defined(__unix__) || defined(__APPLE__)
+#include <registers.h> /* Host Register File */
 #endif
 
-#if defined(__XC) || defined(HI_TECH_C) || defined (__MINGW32__)
+#if defined(__XC) || defined(HI_TECH_C) || defined (HOST_BUILD)
 
 #include <stdint.h>        /* For uint8_t definition */
 #include <stdbool.h>       /* For true/false definition */
@@ -68,10 +70,19 @@
 // Project includes
 #include "pwm.h"
 #include "adxl362.h"
+#include "sw_timer.h"
+#include "clock.h"
+#include "event.h"
+#include "tone.h"
+#include "usage.h"
+#include "led.h"
+#include "battery.h"
 #include "wake_on_sleep.h"
 
 // Time base defines
+#ifndef USEC_PER_TICK
 #define USEC_PER_TICK (10000) // 10.000 msec
+#endif
 
 // Common time definitions
 #define USEC_PER_SEC    (1000000)
@@ -79,25 +90,33 @@
 #define SEC_PER_MSEC    (1000)
 
 // Timeout definitions
-#define EXPIRED (0)
 #define ALERT_TIMEOUT_USEC                      (10000000)  // 10 sec
-#define HEARTBEAT_TIMEOUT_USEC                  (200000)    // 200 msec
-#define SOUND_ON_USEC 				(250000)    // 250 msec
-#define SOUND_OFF_USEC 				(750000)    // 750 msec
-#define INIT_BEEP_USEC                          (125000)    // 125 msec
 #define SLEEP_WAIT_USEC                         (500000)    // 500 msec
 
-// Power-on "announcement" beeps
-#define NUM_ANNOUNCE_BEEPS (3)
-
 // Timeout counter definitions
 #define ONE_SECOND_TIMEOUT_COUNT ((SEC_PER_MSEC * MSEC_PER_USEC) / USEC_PER_TICK)
+#if defined (HOST_BUILD)
+#define ALERT_TIMEOUT_COUNT (wake_on_sleep_params.alert_timeout_usec / USEC_PER_TICK)
+#else
 #define ALERT_TIMEOUT_COUNT (ALERT_TIMEOUT_USEC / USEC_PER_TICK)
-#define HEARTBEAT_TIMEOUT_COUNT (HEARTBEAT_TIMEOUT_USEC / USEC_PER_TICK)
-#define SOUND_ON_TIMEOUT_COUNT (SOUND_ON_USEC / USEC_PER_TICK)
-#define SOUND_OFF_TIMEOUT_COUNT (SOUND_OFF_USEC / USEC_PER_TICK)
-#define ANNOUNCE_BEEP_TIMEOUT_COUNT (INIT_BEEP_USEC / USEC_PER_TICK)
+#endif
+#if defined (HOST_BUILD)
+#define SLEEP_WAIT_COUNT (wake_on_sleep_params.sleep_wait_usec / USEC_PER_TICK)
+#else
 #define SLEEP_WAIT_COUNT (SLEEP_WAIT_USEC / USEC_PER_TICK)
+#endif
+
+/*
+ * Controller state list, X(state, enter, run, exit). The state enum, the
+ * callback prototypes and the dispatch are all generated from it. The
+ * dispatch is the function-pointer table, or with CONTROLLER_FSM_SWITCH a
+ * switch of direct calls expanded in wake_on_sleep_tick().
+ */
+#define CONTROLLER_STATES(X) \
+    X(controller_sleep, fsm_sleep_enter, fsm_sleep_run, fsm_sleep_exit) \
+    X(controller_init, fsm_init_enter, fsm_init_run, fsm_init_exit) \
+    X(controller_alert, fsm_alert_enter, fsm_alert_run, fsm_alert_exit) \
+    X(controller_eol, fsm_eol_enter, fsm_eol_run, fsm_eol_exit)
 
 /*
  * Controller States.
@@ -106,9 +125,9 @@ typedef enum _controller_state_t
 {
     // Note: sleep state is defined first
     // since we want the LEDs to be off in this mode.
-    controller_sleep = 0,
-    controller_init,
-    controller_alert,
+#define CONTROLLER_STATE_ENUM(id, enter, run, exit) id,
+    CONTROLLER_STATES(CONTROLLER_STATE_ENUM)
+#undef CONTROLLER_STATE_ENUM
     controller_unknown
 
 } controller_state_t, *controller_state_ptr_t;
@@ -122,6 +141,7 @@ typedef struct _controller_state_var_t
     controller_state_t current;
 } controller_fsm_state_vars_t, *controller_state_var_ptr_t;
 
+#if !defined (CONTROLLER_FSM_SWITCH)
 /*
  * Controller state-transition table.
  */
@@ -136,14 +156,15 @@ typedef struct _controller_fsm_state_t
     void (*exit)(void);
 
 } controller_fsm_tabel_t, *controller_fsm_state_ptr_t;
+#endif
 
 /*
  * Controller init state-data.
  */
 typedef struct _controller_init_state_data_t
 {
-    uint8_t beep_count;
-    uint8_t sound_count;
+    sw_timer_t sound_timer;
+    tone_t tone;
 } controller_init_state_data_t, *controller_init_state_data_ptr_t;
 
 /*
@@ -151,7 +172,7 @@ typedef struct _controller_init_state_data_t
  */
 typedef struct _controller_sleep_state_data_t
 {
-    uint8_t sleep_wait_count;
+    sw_timer_t sleep_wait_timer;
 } controller_sleep_state_data_t, *controller_sleep_state_data_ptr_t;
 
 /*
@@ -159,15 +180,17 @@ typedef struct _controller_sleep_state_data_t
  */
 typedef struct _controller_alert_state_data_t
 {
-    uint16_t alert_count;
-    uint8_t sound_count;
-    uint8_t alert_profile_index;
+    sw_timer_t alert_timer;
+    sw_timer_t sound_timer;
+    tone_t tone;
+    bool active; // nAWAKE low, as of the last edge
 } controller_alert_state_data_t, *controller_alert_state_data_ptr_t;
 
 /*
  * Controller state-data union.
  * All structures here are shared state variables
  * which must be initialized upon state entry.
+ * Timers held here must be stopped upon state exit.
  */
 typedef union _controller_fsm_data_t
 {
@@ -184,84 +207,245 @@ typedef struct _controller_fsm_t
 {
     controller_fsm_state_vars_t state;
     controller_fsm_data_t data;
+#if !defined (CONTROLLER_FSM_SWITCH)
     controller_fsm_tabel_t const * table;
+#endif
+    uint8_t event; // Being handled, see event.h
 } controller_fsm_t, *controller_fsm_ptr_t;
 
-/*
- * Alert profile structure definition.
- */
-typedef struct _alert_profile_t
-{
-    uint8_t range;
-    uint8_t count[2]; // on/off
-
-} alert_profile_t, *alert_profile_ptr_t;
-
 /*
  * Local Function Declarations.
  */
 
-static void update_heartbeat(void);
+static uint8_t alert_seconds_left(void);
+static bool sound_step(tone_ptr_t tone, sw_timer_ptr_t timer, uint8_t left);
+#if defined (TICK_HISTOGRAM)
+static void tick_record(void);
+#endif
+#if defined (FSM_PROFILE)
+static uint16_t profile_cycles(void);
+static void profile_record(uint8_t state, uint8_t callback, uint16_t start);
+#define PROFILE_START(start) ((start) = profile_cycles())
+#define PROFILE_END(state, callback, start) \
+    profile_record((state), (callback), (start))
+#else
+#define PROFILE_START(start)
+#define PROFILE_END(state, callback, start)
+#endif
 
-// init-state prototypes
-static void fsm_init_enter(void);
-static controller_state_t fsm_init_run(void);
-static void fsm_init_exit(void);
+// Usage log, see usage.h
+#if defined (USAGE_LOG)
+#define USAGE_TICK(state) usage_tick(state)
+#define USAGE_STATE(state) usage_state(state)
+#define USAGE_ALERT(outcome) usage_alert(outcome)
+#define USAGE_SAVE() usage_save()
+#define USAGE_SLEEP(state) usage_sleep(state)
+#define USAGE_STOP() usage_stop()
+#else
+#define USAGE_TICK(state)
+#define USAGE_STATE(state)
+#define USAGE_ALERT(outcome)
+#define USAGE_SAVE()
+#define USAGE_SLEEP(state) SLEEP()
+#define USAGE_STOP()
+#endif
 
-// sleep-state prototypes
-static void fsm_sleep_enter(void);
-static controller_state_t fsm_sleep_run(void);
-static void fsm_sleep_exit(void);
+// LED patterns, see led.h
+#if (LED_MODE != LED_MODE_OFF)
+#define LED_INIT() led_init()
+#define LED_STATE(state) led_state(state)
+#define LED_OFF() led_off()
+#else
+#define LED_INIT()
+#define LED_STATE(state)
+#define LED_OFF()
+#endif
 
-// alert-state prototypes
-static void fsm_alert_enter(void);
-static controller_state_t fsm_alert_run(void);
-static void fsm_alert_exit(void);
+// State prototypes
+#define CONTROLLER_STATE_PROTOTYPES(id, enter, run, exit) \
+    static void enter(void); \
+    static controller_state_t run(void); \
+    static void exit(void);
+CONTROLLER_STATES(CONTROLLER_STATE_PROTOTYPES)
+#undef CONTROLLER_STATE_PROTOTYPES
+
+// State dispatch. FSM_RUN leaves the next state in the current one.
+#if !defined (CONTROLLER_FSM_SWITCH)
+#define FSM_ENTER(state_id) controller_fsm_table[(state_id)].enter()
+#define FSM_RUN(state_id) \
+    controller_fsm.state.current = controller_fsm_table[(state_id)].run()
+#define FSM_EXIT(state_id) controller_fsm_table[(state_id)].exit()
+#else
+// Expanded in place, no dispatch function of its own on the call stack
+#define FSM_ENTER_CASE(id, enter, run, exit) case id: enter(); break;
+#define FSM_RUN_CASE(id, enter, run, exit) \
+    case id: controller_fsm.state.current = run(); break;
+#define FSM_EXIT_CASE(id, enter, run, exit) case id: exit(); break;
+#define FSM_ENTER(state_id) \
+    switch (state_id) { CONTROLLER_STATES(FSM_ENTER_CASE) default: break; }
+#define FSM_RUN(state_id) \
+    switch (state_id) { CONTROLLER_STATES(FSM_RUN_CASE) default: break; }
+#define FSM_EXIT(state_id) \
+    switch (state_id) { CONTROLLER_STATES(FSM_EXIT_CASE) default: break; }
+#endif
 
 /*
  * Local static variable declarations.
  */
 
-static const alert_profile_t alert_profile[] =
-{
-{ 3,
-{ SOUND_ON_TIMEOUT_COUNT, SOUND_OFF_TIMEOUT_COUNT } },
-{ 1,
-{ SOUND_ON_TIMEOUT_COUNT, SOUND_OFF_TIMEOUT_COUNT / 3 } },
-{ 0,
-{ SOUND_ON_TIMEOUT_COUNT * 4, 0 } } };
-
+#if !defined (CONTROLLER_FSM_SWITCH)
 static controller_fsm_tabel_t const controller_fsm_table[] =
 {
-// Note: These must be listed in numerical order by state value.
-        { controller_sleep, fsm_sleep_enter, fsm_sleep_run, fsm_sleep_exit },
-        { controller_init, fsm_init_enter, fsm_init_run, fsm_init_exit },
-        { controller_alert, fsm_alert_enter, fsm_alert_run, fsm_alert_exit } };
+// Note: Listed in numerical order by state value, as is the enum.
+#define CONTROLLER_STATE_ENTRY(id, enter, run, exit) \
+        { id, enter, run, exit },
+        CONTROLLER_STATES(CONTROLLER_STATE_ENTRY)
+#undef CONTROLLER_STATE_ENTRY
+};
+#endif
 
 static controller_fsm_t controller_fsm;
 
+#if defined (TICK_HISTOGRAM)
+#if defined (HOST_BUILD)
+#error TICK_HISTOGRAM measures Timer0, build it for a target.
+#endif
+uint16_t tick_histogram[TICK_HISTOGRAM_BINS];
+#endif
+
+#if defined (FSM_PROFILE)
+#if defined (HOST_BUILD)
+#error FSM_PROFILE counts Timer1 cycles, build it for a target.
+#endif
+fsm_profile_t fsm_profile[FSM_PROFILE_STATES][FSM_PROFILE_CALLBACKS];
+
+// FSM_PROFILE_SLEEP to _EOL must follow CONTROLLER_STATES
+typedef char fsm_profile_order_t[((FSM_PROFILE_SLEEP == controller_sleep)
+        && (FSM_PROFILE_INIT == controller_init)
+        && (FSM_PROFILE_ALERT == controller_alert)
+        && (FSM_PROFILE_EOL == controller_eol)
+        && (FSM_PROFILE_STATES == controller_unknown)) ? 1 : -1];
+#endif
+
+#if defined (HOST_BUILD)
+wake_on_sleep_params_t wake_on_sleep_params =
+{ ALERT_TIMEOUT_USEC, SLEEP_WAIT_USEC };
+#endif
+
 /*
  * Implementation
  */
 
-/*! \brief update_heartbeat
+/*! \brief alert_seconds_left
+ *
+ * Whole seconds the alert has left, rounded up.
+ */
+static uint8_t alert_seconds_left(void)
+{
+    controller_alert_state_data_ptr_t alert_data = &controller_fsm.data.alert;
+    uint16_t seconds = (sw_timer_remaining(&alert_data->alert_timer)
+            / ONE_SECOND_TIMEOUT_COUNT) + 1;
+
+    return (seconds < TONE_NO_DEADLINE) ? (uint8_t) seconds : TONE_NO_DEADLINE;
+}
+
+/*! \brief sound_step
+ *
+ * Plays the next step of a tone sequence and times it. Returns false once
+ * the sound holds until stopped or the sequence has ended.
+ */
+static bool sound_step(tone_ptr_t tone, sw_timer_ptr_t timer, uint8_t left)
+{
+    uint8_t ticks = tone_step(tone, left);
+
+    if (ticks > 0)
+    {
+        sw_timer_start(timer, ticks, SW_TIMER_ONE_SHOT, NULL);
+    }
+
+    return (ticks > 0);
+}
+
+#if defined (TICK_HISTOGRAM)
+
+/*! \brief tick_record
+ *
+ * Adds the work of this tick to the histogram, the counts saturate.
  */
-static void update_heartbeat(void)
+static void tick_record(void)
 {
-    static uint16_t heartbeat_count = HEARTBEAT_TIMEOUT_COUNT;
+    uint8_t bin = TICK_HISTOGRAM_BINS - 1;
 
-    if (heartbeat_count-- == EXPIRED)
+    // The ISR takes an expired tick at once, it is then pending as an event
+    if (!TIMER_EXPIRED && !event_pending() && (TIMER_ELAPSED < bin))
     {
-        // Reset heart beat timeout
-        heartbeat_count = HEARTBEAT_TIMEOUT_COUNT;
+        bin = TIMER_ELAPSED;
+    }
 
-        // Toggle heart beat
-        HEARTBEAT_PORT ^= HEARTBEAT;
+    if (tick_histogram[bin] != UINT16_MAX)
+    {
+        tick_histogram[bin]++;
     }
 
     return;
 }
 
+#endif
+
+#if defined (FSM_PROFILE)
+
+/*! \brief profile_cycles
+ *
+ * Reads Timer1 a byte at a time, a carry out of the low byte between the
+ * two reads of the high byte takes another pass.
+ */
+static uint16_t profile_cycles(void)
+{
+    uint8_t high;
+    uint8_t low;
+
+    do
+    {
+        high = CYCLES_HIGH;
+        low = CYCLES_LOW;
+    } while (high != CYCLES_HIGH);
+
+    return ((uint16_t) high << 8) | low;
+}
+
+/*! \brief profile_record
+ */
+static void profile_record(uint8_t state, uint8_t callback, uint16_t start)
+{
+    uint16_t cycles = profile_cycles() - start;
+    fsm_profile_ptr_t entry;
+
+    if (state >= FSM_PROFILE_STATES)
+    {
+        return;
+    }
+    entry = &fsm_profile[state][callback];
+
+    if (cycles > entry->max)
+    {
+        entry->max = cycles;
+    }
+
+    // Halve rather than saturate, the mean carries on
+    while ((entry->count == UINT8_MAX)
+            || (entry->sum > (UINT16_MAX - cycles)))
+    {
+        entry->count >>= 1;
+        entry->sum = (entry->count != 0) ? (entry->sum >> 1) : 0;
+    }
+    entry->count++;
+    entry->sum += cycles;
+
+    return;
+}
+
+#endif
+
 /*! \brief fsm_init_enter
  */
 static void fsm_init_enter(void)
@@ -275,10 +459,13 @@ static void fsm_init_enter(void)
     // Initialize the ADXL362 for autonomous operation
     adxl362_init();
 
-    // Initialize the "Ready Announcement"
-    init_data->sound_count = ANNOUNCE_BEEP_TIMEOUT_COUNT;
-    init_data->beep_count = NUM_ANNOUNCE_BEEPS;
-    pwm_start(); // Start the PWM module.
+    // Play the "Ready Announcement", unless the battery would not take it
+    if (battery_measure() < BATTERY_CRITICAL)
+    {
+        tone_start(&init_data->tone, tone_announce);
+        sound_step(&init_data->tone, &init_data->sound_timer,
+                TONE_NO_DEADLINE);
+    }
 
     return;
 }
@@ -290,30 +477,18 @@ static controller_state_t fsm_init_run(void)
     controller_init_state_data_ptr_t init_data = &controller_fsm.data.init;
     controller_state_t state = controller_init;
 
+    if (battery_level() >= BATTERY_CRITICAL)
+    {
+        // Nothing announced, transition to the sleep state
+        state = controller_sleep;
+    }
     // Announce "ready"
-    if (init_data->sound_count-- == EXPIRED)
+    else if ((sw_timer_expired(&init_data->sound_timer) == true)
+            && (sound_step(&init_data->tone, &init_data->sound_timer,
+                    TONE_NO_DEADLINE) == false))
     {
-        // Sound on?
-        if (pwm_is_on() == true)
-        {
-            // Sound off
-            pwm_stop();
-
-            // One beep generated.
-            if (--init_data->beep_count == 0)
-            {
-                // Transition to the sleep state and wait
-                state = controller_sleep;
-            }
-        }
-        else
-        {
-            // Sound on
-            pwm_start();
-        }
-
-        // Restart beep-on timer
-        init_data->sound_count = ANNOUNCE_BEEP_TIMEOUT_COUNT;
+        // Announced, transition to the sleep state and wait
+        state = controller_sleep;
     }
 
     return state;
@@ -323,6 +498,10 @@ static controller_state_t fsm_init_run(void)
  */
 static void fsm_init_exit(void)
 {
+    controller_init_state_data_ptr_t init_data = &controller_fsm.data.init;
+
+    sw_timer_stop(&init_data->sound_timer);
+
     return;
 }
 
@@ -332,8 +511,15 @@ static void fsm_sleep_enter(void)
 {
     controller_sleep_state_data_ptr_t sleep_data = &controller_fsm.data.sleep;
 
+    // Measure the battery once per sleep cycle, right after the alert
+    battery_measure();
+
+    // Wake on nAWAKE rising, asleep (or a FIFO batch)
+    nAWAKE_RISE;
+
     // Initialize sleep wait timeout
-    sleep_data->sleep_wait_count = SLEEP_WAIT_COUNT;
+    sw_timer_start(&sleep_data->sleep_wait_timer, SLEEP_WAIT_COUNT,
+            SW_TIMER_ONE_SHOT, NULL);
 
     return;
 }
@@ -344,21 +530,60 @@ static controller_state_t fsm_sleep_run(void)
 {
     controller_state_t state = controller_sleep;
     controller_sleep_state_data_ptr_t sleep_data = &controller_fsm.data.sleep;
+#if (ADXL362_FIFO_MODE != ADXL362_FIFO_OFF)
+    uint8_t status;
+#endif
 
+    if (battery_level() == BATTERY_EOL)
+    {
+        // The battery is spent, stop for good
+        state = controller_eol;
+    }
     // Wait for controller to settle
-    if (sleep_data->sleep_wait_count-- == EXPIRED)
+    else if (sw_timer_expired(&sleep_data->sleep_wait_timer) == true)
     {
+#if !defined (ADXL362_AUTONOMOUS)
         // Put accelerometer into auto-sleep mode
         adxl362_autosleep(true);
+#endif
         
-        // Turn off heart beat
-        HEARTBEAT_PORT &= ~HEARTBEAT;
+        // Turn off the LEDs
+        LED_OFF();
+
+        // Write the log while interrupts are still on, it takes a while
+        USAGE_SAVE();
         
         // Put controller into sleep mode
         // *** SLEEP until nAWAKE goes high ***
         // *** ZZZzzz...
+        // Interrupts are held off so the ISR can not take the flag before
+        // SLEEP(), it posts the edge once they are back on. The tick is
+        // off, only nAWAKE is to end SLEEP().
+#if (ADXL362_FIFO_MODE == ADXL362_FIFO_OFF)
+        INTERRUPTS_OFF;
+        TICK_STOP;
         nAWAKE_CLEAR; // clear interrupt
-        SLEEP();
+        USAGE_SLEEP(controller_sleep);
+        TICK_START;
+        INTERRUPTS_ON;
+#else
+        // nAWAKE rises once per FIFO batch, drain each batch and go back
+        // to sleep for as long as the accelerometer is awake.
+        do
+        {
+            // Clear first, a batch completing during the drain re-arms it
+            INTERRUPTS_OFF;
+            TICK_STOP;
+            nAWAKE_CLEAR; // clear interrupt
+            status = adxl362_fifo_drain(NULL);
+            if (status & ADXL362_STATUS_AWAKE)
+            {
+                USAGE_SLEEP(controller_sleep);
+            }
+            TICK_START;
+            INTERRUPTS_ON;
+        } while (status & ADXL362_STATUS_AWAKE);
+#endif
 
         // ...huh? I'm awake!
         // We are not active, sound the alert!
@@ -372,8 +597,14 @@ static controller_state_t fsm_sleep_run(void)
  */
 static void fsm_sleep_exit(void)
 {
+    controller_sleep_state_data_ptr_t sleep_data = &controller_fsm.data.sleep;
+
+    sw_timer_stop(&sleep_data->sleep_wait_timer);
+
+#if !defined (ADXL362_AUTONOMOUS)
     // Take accelerometer out of auto-sleep mode
     adxl362_autosleep(false);
+#endif
 
     // Exit sleep mode
     return;
@@ -386,12 +617,21 @@ static void fsm_alert_enter(void)
     controller_alert_state_data_ptr_t alert_data = &controller_fsm.data.alert;
 
     // Initialize state variables
-    alert_data->alert_count = ALERT_TIMEOUT_COUNT;
-    alert_data->sound_count = SOUND_ON_TIMEOUT_COUNT;
-    alert_data->alert_profile_index = 0;
+    sw_timer_start(&alert_data->alert_timer, ALERT_TIMEOUT_COUNT,
+            SW_TIMER_ONE_SHOT, NULL);
+
+#if (ADXL362_FIFO_MODE == ADXL362_FIFO_OFF)
+    // Activity is the falling edge. Take the level once the edge is armed,
+    // activity may have come before.
+    nAWAKE_FALL;
+    alert_data->active = !adxl362_is_asleep();
+#endif
 
-    // Start the PWM module.
-    pwm_start();
+    // Start the alert sequence, shorter beeps on a low battery.
+    tone_start(&alert_data->tone,
+            (battery_level() >= BATTERY_LOW) ? tone_alert_low : tone_alert);
+    sound_step(&alert_data->tone, &alert_data->sound_timer,
+            alert_seconds_left());
 
     return;
 }
@@ -405,57 +645,32 @@ static controller_state_t fsm_alert_run(void)
     controller_alert_state_data_ptr_t alert_data = &controller_fsm.data.alert;
 
     // Get current accelerometer state
+#if (ADXL362_FIFO_MODE == ADXL362_FIFO_OFF)
+    // Only an edge changes it, the level tells a stale edge apart
+    if (controller_fsm.event == EVENT_NAWAKE)
+    {
+        alert_data->active = !adxl362_is_asleep();
+    }
+    awake = alert_data->active;
+#else
+    // nAWAKE marks FIFO batches, ask the accelerometer
     awake = !adxl362_is_asleep();
+#endif
 
     // Any activity or timeout, go back to sleep
-    if ((awake) || (alert_data->alert_count == EXPIRED))
+    if ((awake) || (sw_timer_expired(&alert_data->alert_timer) == true))
     {
+        USAGE_ALERT(awake ? USAGE_ALERT_CANCELLED : USAGE_ALERT_TIMED_OUT);
+
         // Go back to sleep
         state = controller_sleep;
     }
-    else
+    else if (sw_timer_expired(&alert_data->sound_timer) == true)
     {
-        // Adjust alert timeout counter
-        --alert_data->alert_count;
-
-        // Sound timeout?
-        if (alert_data->sound_count-- == EXPIRED)
-        {
-            uint8_t seconds_remaining = (alert_data->alert_count / 100) + 1;
-
-            // Update alert profile
-            if ((seconds_remaining
-                    <= alert_profile[alert_data->alert_profile_index].range)
-                    && (alert_data->alert_profile_index
-                            < sizeof(alert_profile) / sizeof(alert_profile_t)))
-            {
-                // Choose next profile
-                alert_data->alert_profile_index++;
-            }
-
-            // Sound on?
-            if (pwm_is_on() == false)
-            {
-                // Configure counter and turn on sound.
-                alert_data->sound_count =
-                        alert_profile[alert_data->alert_profile_index].count[0];
-                if (alert_data->sound_count > 0)
-                {
-                    pwm_start();
-                }
-            }
-            // Sound off
-            else
-            {
-                // Configure counter and turn off sound.
-                alert_data->sound_count =
-                        alert_profile[alert_data->alert_profile_index].count[1];
-                if (alert_data->sound_count > 0)
-                {
-                    pwm_stop();
-                }
-            }
-        }
+        // Next step of the alert sequence, a held sound lasts until the
+        // alert ends
+        sound_step(&alert_data->tone, &alert_data->sound_timer,
+                alert_seconds_left());
     }
 
     return state;
@@ -465,61 +680,193 @@ static controller_state_t fsm_alert_run(void)
  */
 static void fsm_alert_exit(void)
 {
+    controller_alert_state_data_ptr_t alert_data = &controller_fsm.data.alert;
+
+    sw_timer_stop(&alert_data->alert_timer);
+    sw_timer_stop(&alert_data->sound_timer);
+
     // Stop the PWM module.
     pwm_stop();
 
     return;
 }
 
-/*! \brief main
+/*! \brief fsm_eol_enter
  */
-int main(void)
+static void fsm_eol_enter(void)
+{
+    // Nothing is to wake the core. nAWAKE goes off first, the standby
+    // unmaps the pin and could edge it. The log is written out.
+    nAWAKE_DISABLE;
+    adxl362_standby();
+    USAGE_STOP();
+
+    return;
+}
+
+/*! \brief fsm_eol_run
+ */
+static controller_state_t fsm_eol_run(void)
+{
+    // Turn off the LEDs
+    LED_OFF();
+
+    // *** SLEEP for good, only a reset (a new battery) ends it ***
+    // nAWAKE is off (see fsm_eol_enter()), the tick goes off and stays off
+    INTERRUPTS_OFF;
+    TICK_STOP;
+    nAWAKE_CLEAR; // clear interrupt
+    SLEEP();
+    INTERRUPTS_ON;
+
+    return controller_eol;
+}
+
+/*! \brief fsm_eol_exit
+ */
+static void fsm_eol_exit(void)
+{
+    return;
+}
+
+/*! \brief wake_on_sleep_init
+ */
+void wake_on_sleep_init(void)
 {
 
+    // Empty before init() enables interrupts
+    event_init();
+
     init();
 
+#if defined (FSM_PROFILE)
+    CYCLES_START;
+#endif
+
+#if defined (USAGE_LOG)
+    usage_init();
+#endif
+
+    // Start the software timers and the LED patterns, which run in every
+    // state.
+    sw_timer_init();
+    LED_INIT();
+
     // Initialize state variables.
     controller_fsm.state.previous = controller_unknown;
     controller_fsm.state.current = controller_init;
 
+#if !defined (CONTROLLER_FSM_SWITCH)
     // Link in state transition table.
     controller_fsm.table = controller_fsm_table;
+#endif
 
-    do
+    return;
+}
+
+/*! \brief wake_on_sleep_tick
+ */
+void wake_on_sleep_tick(void)
+{
+#if defined (FSM_PROFILE)
+    uint16_t start;
+#endif
+
+    // Wait (idle) for the next event
+    controller_fsm.event = idle();
+
+    switch (controller_fsm.event)
     {
-        // Wait for periodic timeout
-        while (!TIMER_EXPIRED);
-        TIMER_RESET;
+    case EVENT_TICK:
+        // Finish a tone whose EVENT_PWM was dropped
+        pwm_service();
+        sw_timer_tick();
+        USAGE_TICK(controller_fsm.state.current);
+        break;
+
+    case EVENT_PWM:
+        // A stopped tone ended its period, nothing for the controller
+        pwm_service();
+        return;
+
+    default:
+        // nAWAKE edge, the controller runs at once
+        break;
+    }
 
-        update_heartbeat();
+    /*
+     * Controller Finite State Machine
+     */
 
-        /*
-         * Controller Finite State Machine
-         */
+    // Entry
+    if (controller_fsm.state.previous != controller_fsm.state.current)
+    {
+        PROFILE_START(start);
+        FSM_ENTER(controller_fsm.state.current);
+        PROFILE_END(controller_fsm.state.current, FSM_PROFILE_ENTER, start);
+        controller_fsm.state.previous = controller_fsm.state.current;
+    }
 
-        // Entry
-        if (controller_fsm.state.previous != controller_fsm.state.current)
-        {
-            controller_fsm_table[controller_fsm.state.current].enter();
-            controller_fsm.state.previous = controller_fsm.state.current;
-        }
+    // Run
+    PROFILE_START(start);
+    FSM_RUN(controller_fsm.state.current);
+    PROFILE_END(controller_fsm.state.previous, FSM_PROFILE_RUN, start);
 
-        // Run
-        controller_fsm.state.current =
-                controller_fsm_table[controller_fsm.state.current].run();
+    // Exit
+    if (controller_fsm.state.previous != controller_fsm.state.current)
+    {
+        PROFILE_START(start);
+        FSM_EXIT(controller_fsm.state.previous);
+        PROFILE_END(controller_fsm.state.previous, FSM_PROFILE_EXIT, start);
+        USAGE_STATE(controller_fsm.state.current);
+    }
 
-        // Exit
-        if (controller_fsm.state.previous != controller_fsm.state.current)
-        {
-            controller_fsm_table[controller_fsm.state.previous].exit();
-        }
+    // Show the state, see led.h. Dark from a critical battery on.
+    if (battery_level() < BATTERY_CRITICAL)
+    {
+        LED_STATE(controller_fsm.state.current);
+    }
+    else
+    {
+        LED_OFF();
+    }
 
-        // Clear and set state bits
-        STATE_PORT &= ~STATE_MASK;
-        STATE_PORT |=
-                ((controller_fsm.state.current & 0x03) << STATE_BITS_SHIFT);
+#if defined (TICK_HISTOGRAM)
+    if (controller_fsm.event == EVENT_TICK)
+    {
+        tick_record();
+    }
+#endif
+
+    return;
+}
+
+#if defined (HOST_BUILD)
+
+/*! \brief wake_on_sleep_state
+ */
+uint8_t wake_on_sleep_state(void)
+{
+    return (uint8_t) controller_fsm.state.current;
+}
+
+#endif
+
+#ifndef WAKE_ON_SLEEP_NO_MAIN
+
+/*! \brief main
+ */
+int main(void)
+{
+    wake_on_sleep_init();
+
+    do
+    {
+        wake_on_sleep_tick();
 
     } while (true);
 
     return 0;
 }
+
+#endif
@@ -60,6 +60,126 @@ extern "C"
      */
     /* ************************************************************************* */
 
+#if defined (TICK_HISTOGRAM)
+    /*
+     * Tick work histogram, built when TICK_HISTOGRAM is defined. Bin n
+     * counts the ticks whose work ended n Timer0 counts after TIMER_RESET;
+     * the last bin also takes ticks that ran into the next event. A tick
+     * that sleeps counts only its time awake. Read it with the debugger.
+     */
+#define TICK_HISTOGRAM_BINS (8)
+    extern uint16_t tick_histogram[TICK_HISTOGRAM_BINS];
+#endif
+
+#if defined (FSM_PROFILE)
+    /*
+     * State machine profile, built when FSM_PROFILE is defined. One entry
+     * per state and callback, in instruction cycles counted by Timer1 on
+     * FOSC/4 whatever the clock level. Time spent in SLEEP is not counted.
+     * An entry is 5 bytes, 60 for the table, to fit the 16F1823: max, and
+     * sum and count for the mean. Once either would overflow both are
+     * halved, sum / count stays the mean, weighted to the latest calls.
+     * There is no min, the headroom is set by max. Read it with the
+     * debugger.
+     */
+#define FSM_PROFILE_SLEEP (0) // In the order of CONTROLLER_STATES
+#define FSM_PROFILE_INIT (1)
+#define FSM_PROFILE_ALERT (2)
+#define FSM_PROFILE_EOL (3)
+#define FSM_PROFILE_STATES (4)
+#define FSM_PROFILE_ENTER (0)
+#define FSM_PROFILE_RUN (1)
+#define FSM_PROFILE_EXIT (2)
+#define FSM_PROFILE_CALLBACKS (3)
+
+    typedef struct _fsm_profile_t
+    {
+        uint16_t max;
+        uint16_t sum;
+        uint8_t count;
+
+    } fsm_profile_t, *fsm_profile_ptr_t;
+
+    extern fsm_profile_t
+            fsm_profile[FSM_PROFILE_STATES][FSM_PROFILE_CALLBACKS];
+#endif
+
+#if defined (HOST_BUILD)
+    /*
+     * Controller timeouts, fixed on a target. A host build may change them
+     * between runs, each must be at most 65534 ticks. Less than one tick
+     * counts as one.
+     */
+    typedef struct _wake_on_sleep_params_t
+    {
+        uint32_t alert_timeout_usec; // Alert sounds, then back to sleep
+        uint32_t sleep_wait_usec; // Settle before SLEEP
+
+    } wake_on_sleep_params_t, *wake_on_sleep_params_ptr_t;
+
+    extern wake_on_sleep_params_t wake_on_sleep_params;
+#endif
+
+    /* ************************************************************************* */
+    /*!
+     \ingroup wake_on_sleep
+
+     \brief wake_on_sleep_init
+
+     Initializes the device, the software timers and the controller state
+     machine, which starts in the init state.
+
+     \param[in] None.
+
+     \return Nothing.
+
+     */
+    /* ************************************************************************* */
+
+    void wake_on_sleep_init(void);
+
+    /* ************************************************************************* */
+    /*!
+     \ingroup wake_on_sleep
+
+     \brief wake_on_sleep_tick
+
+     Idles until the next event, see event.h. A tick advances the software
+     timers and runs the controller state machine once, an nAWAKE edge runs
+     it at once, the end of a muted tone only finishes the stop. The
+     current state is shown on the LEDs, see led.h. main() calls it
+     forever, a host build may define WAKE_ON_SLEEP_NO_MAIN and call it from
+     its own loop.
+
+     \param[in] None.
+
+     \return Nothing.
+
+     */
+    /* ************************************************************************* */
+
+    void wake_on_sleep_tick(void);
+
+#if defined (HOST_BUILD)
+    /* ************************************************************************* */
+    /*!
+     \ingroup wake_on_sleep
+
+     \brief wake_on_sleep_state
+
+     The controller state, for a host build that watches the controller.
+     The state LEDs only show it all the time in LED_MODE_BENCH.
+
+     \param[in] None.
+
+     \return The state, 0 sleep, 1 init, 2 alert or 3 end of life.
+
+     */
+    /* ************************************************************************* */
+
+    uint8_t wake_on_sleep_state(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,507 @@
+/*
+ ==============================================================================
+ Name        : adxl362_model.c
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+// Standard includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+// Other includes
+#include "adxl362.h"
+
+// Module include
+#include "adxl362_model.h"
+
+// Local declarations
+
+/* ADXL362 communication commands */
+#define ADXL362_WRITE_REG               0x0A
+#define ADXL362_READ_REG                0x0B
+#define ADXL362_READ_FIFO               0x0D
+
+/* ADXL362 registers, beyond the ones the firmware reads */
+#define ADXL362_REG_DEVID_MST           0x01
+#define ADXL362_REG_PARTID              0x02
+#define ADXL362_REG_REVID               0x03
+
+#define ADXL362_RESET_KEY               0x52
+#define ADXL362_MEASURE_MASK            (3 << 0)
+#define ADXL362_MEASURE                 (2 << 0)
+#define ADXL362_LINK                    (1 << 4) // Linked or loop mode
+#define ADXL362_INACT_REF               (1 << 3)
+#define ADXL362_ACT_REF                 (1 << 1)
+#define ADXL362_ACT_INACT_EN            ((1 << 2) | (1 << 0))
+#define ADXL362_RANGE_SHIFT             (6) // FILTER_CTL, mg per LSB
+
+#define SAMPLE_USEC_12_5HZ              (80000) // ODR = 0
+
+static void adxl362_model_reset(adxl362_model_ptr_t model);
+static bool adxl362_model_peek(adxl362_model_ptr_t model);
+static void adxl362_model_schedule(adxl362_model_ptr_t model);
+static void adxl362_model_hold(adxl362_model_ptr_t model, uint64_t time);
+static bool adxl362_model_beyond(int16_t const * xyz, int16_t const * ref,
+        int32_t threshold);
+static void adxl362_model_scan(adxl362_model_ptr_t model, uint64_t sample);
+static void adxl362_model_write(adxl362_model_ptr_t model, uint64_t now,
+        uint8_t address, uint8_t data);
+static uint8_t adxl362_model_read(adxl362_model_ptr_t model, uint64_t now,
+        uint8_t address);
+static uint8_t adxl362_model_status(adxl362_model_ptr_t model);
+
+// Implementation
+
+/*! \brief adxl362_model_reset
+ */
+static void adxl362_model_reset(adxl362_model_ptr_t model)
+{
+    memset(model->regs, 0, sizeof(model->regs));
+    model->regs[ADXL362_REG_DEVID_AD] = 0xAD;
+    model->regs[ADXL362_REG_DEVID_MST] = 0x1D;
+    model->regs[ADXL362_REG_PARTID] = 0xF2;
+    model->regs[ADXL362_REG_REVID] = 0x01;
+    model->regs[ADXL362_REG_STATUS] = ADXL362_STATUS_ERR_USER_REGS;
+    model->regs[ADXL362_REG_FIFO_SAMPLES] = 0x80;
+    model->regs[ADXL362_REG_FILTER_CTL] = 0x13;
+
+    // Standby, AWAKE defaults to 1 until activity detection runs
+    model->measuring = false;
+    model->awake = true;
+    model->edge = ADXL362_MODEL_NEVER;
+
+    return;
+}
+
+/*! \brief adxl362_model_peek
+ */
+static bool adxl362_model_peek(adxl362_model_ptr_t model)
+{
+    if ((model->pending == false) && (model->motion != NULL))
+    {
+        model->pending = model->motion(model->context, &model->start,
+                &model->end);
+    }
+
+    return model->pending;
+}
+
+/*! \brief adxl362_model_hold
+ *
+ * Holds the last recorded sample at or before a time.
+ */
+static void adxl362_model_hold(adxl362_model_ptr_t model, uint64_t time)
+{
+    while ((model->ended == false) && (model->time <= time))
+    {
+        memcpy(model->xyz, model->next, sizeof(model->xyz));
+        model->ended = !model->sample(model->context, &model->time,
+                model->next);
+    }
+
+    return;
+}
+
+/*! \brief adxl362_model_beyond
+ *
+ * Any axis further than the threshold from the reference.
+ */
+static bool adxl362_model_beyond(int16_t const * xyz, int16_t const * ref,
+        int32_t threshold)
+{
+    int32_t delta;
+    int i;
+
+    for (i = 0; i < 3; i++)
+    {
+        delta = (int32_t) xyz[i] - ref[i];
+        if ((delta > threshold) || (-delta > threshold))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*! \brief adxl362_model_scan
+ *
+ * Runs the detection over the recorded samples for the next transition.
+ */
+static void adxl362_model_scan(adxl362_model_ptr_t model, uint64_t sample)
+{
+    static const int16_t absolute[3] =
+    { 0, 0, 0 };
+    uint8_t const * regs = model->regs;
+    uint8_t range = regs[ADXL362_REG_FILTER_CTL] >> ADXL362_RANGE_SHIFT;
+    bool referenced;
+    int16_t ref[3];
+    int32_t threshold;
+    uint32_t samples;
+    uint32_t count = 0;
+    uint64_t time = model->since;
+
+    if (model->awake == true)
+    {
+        // Inactivity, every axis within the threshold for TIME_INACT
+        referenced = ((regs[ADXL362_REG_ACT_INACT_CTL] & ADXL362_INACT_REF)
+                != 0);
+        threshold = (((regs[ADXL362_REG_THRESH_ACT_L + 4] & 0x07) << 8)
+                | regs[ADXL362_REG_THRESH_ACT_L + 3]) << range;
+        samples = (regs[ADXL362_REG_TIME_INACT_H] << 8)
+                | regs[ADXL362_REG_TIME_INACT_L];
+    }
+    else
+    {
+        // Activity, any axis beyond the threshold for TIME_ACT
+        referenced = ((regs[ADXL362_REG_ACT_INACT_CTL] & ADXL362_ACT_REF)
+                != 0);
+        threshold = (((regs[ADXL362_REG_THRESH_ACT_L + 1] & 0x07) << 8)
+                | regs[ADXL362_REG_THRESH_ACT_L]) << range;
+        samples = regs[ADXL362_REG_TIME_ACT];
+    }
+    if (samples == 0)
+    {
+        samples = 1;
+    }
+
+    // The reference is the first sample of the detection
+    time += sample;
+    adxl362_model_hold(model, time);
+    memcpy(ref, referenced ? model->xyz : absolute, sizeof(ref));
+
+    for (;; time += sample)
+    {
+        adxl362_model_hold(model, time);
+
+        if (adxl362_model_beyond(model->xyz, ref, threshold) != model->awake)
+        {
+            if (++count >= samples)
+            {
+                model->edge = time;
+                break;
+            }
+        }
+        else
+        {
+            count = 0;
+            if ((model->awake == true) && (referenced == true))
+            {
+                memcpy(ref, model->xyz, sizeof(ref));
+            }
+            else if (model->ended == true)
+            {
+                // The held sample never becomes active
+                break;
+            }
+        }
+    }
+
+    return;
+}
+
+/*! \brief adxl362_model_schedule
+ *
+ * Finds the next AWAKE transition from the current state.
+ */
+static void adxl362_model_schedule(adxl362_model_ptr_t model)
+{
+    uint8_t const * regs = model->regs;
+    uint8_t odr = regs[ADXL362_REG_FILTER_CTL] & 0x07;
+    uint64_t sample = SAMPLE_USEC_12_5HZ >> ((odr > 5) ? 5 : odr);
+    uint64_t duration;
+    uint64_t start;
+
+    model->edge = ADXL362_MODEL_NEVER;
+
+    // AWAKE only changes while measuring in linked or loop mode
+    if ((model->measuring == false)
+            || ((regs[ADXL362_REG_ACT_INACT_CTL] & ADXL362_LINK) == 0)
+            || ((regs[ADXL362_REG_ACT_INACT_CTL] & ADXL362_ACT_INACT_EN)
+                    != ADXL362_ACT_INACT_EN))
+    {
+        return;
+    }
+
+    if (model->sample != NULL)
+    {
+        adxl362_model_scan(model, sample);
+    }
+    else if (model->awake == true)
+    {
+        // Inactivity, no motion for TIME_INACT samples
+        duration = sample
+                * ((regs[ADXL362_REG_TIME_INACT_H] << 8)
+                        | regs[ADXL362_REG_TIME_INACT_L]);
+        if (duration == 0)
+        {
+            duration = sample;
+        }
+
+        // Motion before the timer runs out restarts it
+        while ((adxl362_model_peek(model) == true)
+                && (model->start < model->since + duration))
+        {
+            if (model->end > model->since)
+            {
+                model->since = model->end;
+            }
+            model->pending = false;
+        }
+
+        model->edge = model->since + duration;
+    }
+    else
+    {
+        // Activity, motion for TIME_ACT samples
+        duration = sample * regs[ADXL362_REG_TIME_ACT];
+        if (duration == 0)
+        {
+            duration = sample;
+        }
+
+        while (adxl362_model_peek(model) == true)
+        {
+            start = (model->start > model->since) ?
+                    model->start : model->since;
+            if ((model->end > start) && ((model->end - start) >= duration))
+            {
+                model->edge = start + duration;
+                break;
+            }
+            model->pending = false;
+        }
+    }
+
+    return;
+}
+
+/*! \brief adxl362_model_write
+ */
+static void adxl362_model_write(adxl362_model_ptr_t model, uint64_t now,
+        uint8_t address, uint8_t data)
+{
+    bool measuring;
+
+    // Read-only registers
+    if (address < ADXL362_REG_SOFT_RESET)
+    {
+        return;
+    }
+
+    model->regs[address] = data;
+    model->regs[ADXL362_REG_STATUS] &= ~ADXL362_STATUS_ERR_USER_REGS;
+
+    if (address == ADXL362_REG_SOFT_RESET)
+    {
+        if (data == ADXL362_RESET_KEY)
+        {
+            adxl362_model_reset(model);
+        }
+    }
+    else if (address == ADXL362_REG_POWER_CTL)
+    {
+        measuring = ((data & ADXL362_MEASURE_MASK) == ADXL362_MEASURE);
+        if (measuring != model->measuring)
+        {
+            // Measurement starts awake, waiting for inactivity
+            model->measuring = measuring;
+            model->awake = true;
+            model->since = now;
+            adxl362_model_schedule(model);
+        }
+    }
+    else if ((model->measuring == true) && (model->sample == NULL))
+    {
+        // Samples already scanned are not replayed, keep the detection
+        adxl362_model_schedule(model);
+    }
+
+    return;
+}
+
+/*! \brief adxl362_model_read
+ */
+static uint8_t adxl362_model_read(adxl362_model_ptr_t model, uint64_t now,
+        uint8_t address)
+{
+    uint8_t data = model->regs[address];
+
+    if (address == ADXL362_REG_STATUS)
+    {
+        adxl362_model_update(model, now);
+        data = adxl362_model_status(model);
+    }
+
+    return data;
+}
+
+/*! \brief adxl362_model_status
+ */
+static uint8_t adxl362_model_status(adxl362_model_ptr_t model)
+{
+    uint8_t status = model->regs[ADXL362_REG_STATUS]
+            & ADXL362_STATUS_ERR_USER_REGS;
+
+    if (model->awake == true)
+    {
+        status |= ADXL362_STATUS_AWAKE | ADXL362_STATUS_ACT;
+    }
+    else
+    {
+        status |= ADXL362_STATUS_INACT;
+    }
+
+    return status;
+}
+
+/*! \brief adxl362_model_init
+ */
+void adxl362_model_init(adxl362_model_ptr_t model,
+        adxl362_model_motion_t motion, void * context)
+{
+    memset(model, 0, sizeof(*model));
+    model->motion = motion;
+    model->context = context;
+    adxl362_model_reset(model);
+
+    return;
+}
+
+/*! \brief adxl362_model_init_samples
+ */
+void adxl362_model_init_samples(adxl362_model_ptr_t model,
+        adxl362_model_sample_t sample, void * context)
+{
+    adxl362_model_init(model, NULL, context);
+
+    // Prime the next sample, the first one also holds before it
+    model->sample = sample;
+    model->ended = !sample(context, &model->time, model->next);
+    memcpy(model->xyz, model->next, sizeof(model->xyz));
+
+    return;
+}
+
+/*! \brief adxl362_model_update
+ */
+bool adxl362_model_update(adxl362_model_ptr_t model, uint64_t now)
+{
+    while (model->edge <= now)
+    {
+        model->awake = !model->awake;
+        model->since = model->edge;
+        if (model->awake == false)
+        {
+            model->asleep_edge = model->edge;
+        }
+        adxl362_model_schedule(model);
+    }
+
+    return model->awake;
+}
+
+/*! \brief adxl362_model_next_edge
+ */
+uint64_t adxl362_model_next_edge(adxl362_model_ptr_t model)
+{
+    return model->edge;
+}
+
+/*! \brief adxl362_model_int
+ */
+bool adxl362_model_int(adxl362_model_ptr_t model, uint8_t map)
+{
+    uint8_t intmap = model->regs[map];
+    bool active = ((adxl362_model_status(model) & intmap & 0x7F) != 0);
+
+    // INT_LOW inverts the pin
+    return (active != ((intmap & 0x80) != 0));
+}
+
+/*! \brief adxl362_model_select
+ */
+void adxl362_model_select(adxl362_model_ptr_t model, bool selected)
+{
+    // A transaction starts on the select edge
+    if (selected == true)
+    {
+        model->count = 0;
+    }
+
+    return;
+}
+
+/*! \brief adxl362_model_xchg
+ */
+uint8_t adxl362_model_xchg(adxl362_model_ptr_t model, uint64_t now,
+        uint8_t data)
+{
+    uint8_t miso = 0x00;
+
+    if (model->count == 0)
+    {
+        model->command = data;
+        model->count++;
+    }
+    else if ((model->count == 1) && (model->command != ADXL362_READ_FIFO))
+    {
+        model->address = data & 0x3F;
+        model->count++;
+    }
+    else if (model->command == ADXL362_WRITE_REG)
+    {
+        adxl362_model_write(model, now, model->address++ & 0x3F, data);
+    }
+    else if (model->command == ADXL362_READ_REG)
+    {
+        miso = adxl362_model_read(model, now, model->address++ & 0x3F);
+    }
+
+    // The FIFO is not modelled, it always reads empty
+
+    return miso;
+}
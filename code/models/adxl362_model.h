@@ -0,0 +1,271 @@
+/*
+ ==============================================================================
+ Name        : adxl362_model.h
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+#ifndef ADXL362_MODEL_H_
+#define ADXL362_MODEL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************** */
+/*!
+ \defgroup adxl362_model
+
+ \brief These APIs and definitions are for the ADXL362 behaviour model.
+
+ The model answers the SPI protocol of the part from a register file and
+ derives the AWAKE bit, and so the nAWAKE pin, from the activity and
+ inactivity settings the firmware programs. Motion is supplied either as a
+ stream of time intervals or as recorded acceleration samples.
+
+ An interval is motion above the activity threshold, anything outside an
+ interval is below the inactivity threshold. The loop-mode timing is then
+ modelled in continuous time: activity is detected TIME_ACT samples into
+ an interval, inactivity TIME_INACT samples after the last motion ended.
+
+ Recorded samples are held and sampled at the programmed output data rate
+ and run through the activity and inactivity detection, with the thresholds,
+ times and absolute or referenced mode programmed. A referenced detection
+ takes its reference when it starts; inactivity takes a new one whenever a
+ sample breaks it. Settings changed while measuring apply from the next
+ detection.
+
+ The lower wake-up mode rate is not modelled. Times are in microseconds,
+ accelerations in mg.
+ */
+/* ************************************************************************** */
+
+// No further AWAKE transition
+#define ADXL362_MODEL_NEVER (UINT64_MAX)
+
+/*
+ * Motion source, returns the next motion interval [start, end) in time
+ * order, or false once there is no further motion.
+ */
+typedef bool (*adxl362_model_motion_t)(void * context, uint64_t * start,
+        uint64_t * end);
+
+/*
+ * Sample source, returns the next acceleration sample (X, Y, Z) in time
+ * order, or false at the end of the recording. The last sample holds.
+ */
+typedef bool (*adxl362_model_sample_t)(void * context, uint64_t * time,
+        int16_t xyz[3]);
+
+/*
+ * ADXL362 model definition.
+ */
+typedef struct _adxl362_model_t
+{
+    // Register file and SPI transaction state
+    uint8_t regs[64];
+    uint8_t command;
+    uint8_t address;
+    uint8_t count;
+
+    // Motion source and the next interval from it
+    adxl362_model_motion_t motion;
+    void * context;
+    bool pending;
+    uint64_t start;
+    uint64_t end;
+
+    // Sample source, replaces the motion intervals when set
+    adxl362_model_sample_t sample;
+    bool ended;
+    uint64_t time; // Time of the next sample
+    int16_t next[3]; // Next sample
+    int16_t xyz[3]; // Sample held
+
+    // Activity state
+    bool measuring;
+    bool awake;
+    uint64_t since; // Last motion (awake) or start of inactivity (asleep)
+    uint64_t edge; // Next AWAKE transition
+    uint64_t asleep_edge; // Last awake to asleep transition
+
+} adxl362_model_t, *adxl362_model_ptr_t;
+
+/* ************************************************************************** */
+/*!
+ \ingroup adxl362_model
+
+ \brief adxl362_model_init
+
+ Powers up the model, the part is in standby and AWAKE reads 1.
+
+ \param[in] model - model to initialize.
+ \param[in] motion - motion source.
+ \param[in] context - motion source context.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void adxl362_model_init(adxl362_model_ptr_t model,
+        adxl362_model_motion_t motion, void * context);
+
+/* ************************************************************************** */
+/*!
+ \ingroup adxl362_model
+
+ \brief adxl362_model_init_samples
+
+ Powers up the model, driven by recorded samples instead of intervals.
+
+ \param[in] model - model to initialize.
+ \param[in] sample - sample source.
+ \param[in] context - sample source context.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void adxl362_model_init_samples(adxl362_model_ptr_t model,
+        adxl362_model_sample_t sample, void * context);
+
+/* ************************************************************************** */
+/*!
+ \ingroup adxl362_model
+
+ \brief adxl362_model_update
+
+ Advances the model to a point in time, times must not decrease.
+
+ \param[in] model - model to update.
+ \param[in] now - current time.
+
+ \return bool - AWAKE at that time.
+
+ */
+/* ************************************************************************** */
+
+bool adxl362_model_update(adxl362_model_ptr_t model, uint64_t now);
+
+/* ************************************************************************** */
+/*!
+ \ingroup adxl362_model
+
+ \brief adxl362_model_next_edge
+
+ Determines when AWAKE next changes, after the last update.
+
+ \param[in] model - model to query.
+
+ \return uint64_t - time of the next transition or ADXL362_MODEL_NEVER.
+
+ */
+/* ************************************************************************** */
+
+uint64_t adxl362_model_next_edge(adxl362_model_ptr_t model);
+
+/* ************************************************************************** */
+/*!
+ \ingroup adxl362_model
+
+ \brief adxl362_model_int
+
+ Determines the level of an interrupt pin after the last update. Only the
+ AWAKE, ACT and INACT status bits are modelled.
+
+ \param[in] model - model to query.
+ \param[in] map - ADXL362_REG_INTMAP1 or ADXL362_REG_INTMAP2.
+
+ \return bool - true if the pin is high.
+
+ */
+/* ************************************************************************** */
+
+bool adxl362_model_int(adxl362_model_ptr_t model, uint8_t map);
+
+/* ************************************************************************** */
+/*!
+ \ingroup adxl362_model
+
+ \brief adxl362_model_select
+
+ Chip select, a new SPI transaction starts on each selection.
+
+ \param[in] model - model to select.
+ \param[in] selected - true while nCS is asserted.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void adxl362_model_select(adxl362_model_ptr_t model, bool selected);
+
+/* ************************************************************************** */
+/*!
+ \ingroup adxl362_model
+
+ \brief adxl362_model_xchg
+
+ Exchanges one SPI byte with the model.
+
+ \param[in] model - selected model.
+ \param[in] now - current time.
+ \param[in] data - byte on MOSI.
+
+ \return uint8_t - byte on MISO.
+
+ */
+/* ************************************************************************** */
+
+uint8_t adxl362_model_xchg(adxl362_model_ptr_t model, uint64_t now,
+        uint8_t data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ADXL362_MODEL_H_ */
@@ -0,0 +1,173 @@
+/*
+ ==============================================================================
+ Name        : energy.c
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+// Standard includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+// Other includes
+#include "adxl362_model.h"
+#include "sim.h"
+
+// Module include
+#include "energy.h"
+
+// Local declarations
+
+#define USEC_PER_SEC (1000000.0)
+#define SEC_PER_DAY (86400.0)
+#define UAS_PER_MAH (3600000.0)
+
+/*
+ * Current tables at VDD of about 3.0 V from the cell. "ds" marks a
+ * typical from the datasheet in /datasheets, "est" an estimate. INT1/INT2
+ * are push-pull with about 500 ohm output impedance (ds typ) and drive the
+ * Q1/Q2 base through the 1 kohm R2/R3, the pin cannot hold VDD at that
+ * load.
+ */
+const energy_table_t energy_tables[ENERGY_NUM_TARGETS] =
+{
+        {
+                .name = "PIC16F1823",
+                .core_run_ua = 100.0, // est, 500 kHz MFINTOSC
+                .core_idle_ua = 11.5, // est, SLEEP plus the watchdog
+                .core_sleep_ua = 11.0, // est, SLEEP, F part regulator on
+                .tick_usec = 8000.0, // Watchdog 1:256, IDLE_MODE_WDT
+                .tick_run_usec = 1200.0, // est, ~150 cycles at 125 kHz
+                .pwm_spin = true, // Timer2 stops in SLEEP
+                .accel_measure_ua = 1.8, // ds, normal mode at 100 Hz
+                .accel_wakeup_ua = 0.27, // ds
+                .accel_standby_ua = 0.01, // ds
+                .regulator_ua = 0.86, // ds, ADP160 at 1 uA load
+                .speaker_ua = 25000.0, // est, 42 ohm coil at 50% plus Q3
+                .led_ua = 10000.0, // est, (3.0 V - 2.0 V Vf) / 100 ohm
+                .int_ua = 1530.0, // ds/est, 2.3 V / (1 kohm + ~500 ohm pin)
+        },
+        {
+                .name = "PIC18F45K20",
+                .core_run_ua = 2000.0, // est, 8 MHz HFINTOSC
+                .core_idle_ua = 600.0, // est, IDLE with Timer0 running
+                .core_sleep_ua = 0.1, // est
+                .tick_usec = 10000.0,
+                .tick_run_usec = 100.0, // est, ~200 cycles at 2 MIPS
+                .pwm_spin = false,
+                .accel_measure_ua = 1.8, // ds, normal mode at 100 Hz
+                .accel_wakeup_ua = 0.27, // ds
+                .accel_standby_ua = 0.01, // ds
+                .regulator_ua = 0.86, // ds, ADP160 at 1 uA load
+                .speaker_ua = 25000.0, // est, 42 ohm coil at 50% plus Q3
+                .led_ua = 10000.0, // est, (3.0 V - 2.0 V Vf) / 100 ohm
+                .int_ua = 1530.0, // ds/est, 2.3 V / (1 kohm + ~500 ohm pin)
+        } };
+
+// Implementation
+
+/*! \brief energy_integrate
+ */
+void energy_integrate(energy_table_t const * table, sim_stats_t const * stats,
+        uint64_t usec, energy_ptr_t energy)
+{
+    double seconds = usec / USEC_PER_SEC;
+    double sleep = stats->sleep_usec / USEC_PER_SEC;
+    double ticking = seconds - sleep;
+    double run;
+    double measure = stats->measure_usec / USEC_PER_SEC;
+    double wakeup = stats->wakeup_usec / USEC_PER_SEC;
+    double pwm = stats->pwm_usec / USEC_PER_SEC;
+    double speaker = stats->speaker_usec / USEC_PER_SEC;
+
+    memset(energy, 0, sizeof(*energy));
+    energy->seconds = seconds;
+
+    // Core, run for part of each tick and idle in between. Ticks of the
+    // target, a host build with another tick counts a different number.
+    run = (ticking * USEC_PER_SEC / table->tick_usec) * table->tick_run_usec
+            / USEC_PER_SEC;
+    if (table->pwm_spin == true)
+    {
+        run += pwm;
+    }
+    if (run > ticking)
+    {
+        run = ticking;
+    }
+    energy->core = (run * table->core_run_ua)
+            + ((ticking - run) * table->core_idle_ua)
+            + (sleep * table->core_sleep_ua);
+    energy->active = run;
+    energy->spin = (ticking * table->core_run_ua)
+            + (sleep * table->core_sleep_ua);
+
+    // Accelerometer
+    energy->accel = (measure * table->accel_measure_ua)
+            + (wakeup * table->accel_wakeup_ua)
+            + ((seconds - measure - wakeup) * table->accel_standby_ua);
+
+    // Board
+    energy->regulator = seconds * table->regulator_ua;
+    // Coil current taken as proportional to the duty cycle (est)
+    energy->speaker = speaker * table->speaker_ua;
+    energy->leds = (stats->heartbeat_usec + stats->sb0_usec + stats->sb1_usec)
+            / USEC_PER_SEC * table->led_ua;
+    energy->ints = (stats->int1_usec + stats->int2_usec) / USEC_PER_SEC
+            * table->int_ua;
+
+    energy->total = energy->core + energy->accel + energy->regulator
+            + energy->speaker + energy->leds + energy->ints;
+
+    return;
+}
+
+/*! \brief energy_mah_per_day
+ */
+double energy_mah_per_day(energy_t const * energy, double uas)
+{
+    return (energy->seconds > 0) ?
+            ((uas / UAS_PER_MAH) * (SEC_PER_DAY / energy->seconds)) : 0.0;
+}
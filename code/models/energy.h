@@ -0,0 +1,165 @@
+/*
+ ==============================================================================
+ Name        : energy.h
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+#ifndef ENERGY_H_
+#define ENERGY_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************** */
+/*!
+ \defgroup energy
+
+ \brief These APIs and definitions are for the energy accounting model.
+
+ Integrates a current table over the time a simulation spent in each
+ controller state, core mode and output state. Currents are in microamps
+ from the cell; each table entry notes whether it is a datasheet typical
+ or an estimate still to be replaced by a datasheet or bench figure.
+ */
+/* ************************************************************************** */
+
+// CR2032 nominal capacity
+#define ENERGY_CR2032_MAH (225.0)
+
+/*
+ * Current table for one target.
+ */
+typedef struct _energy_table_t
+{
+    char const * name;
+
+    // Controller
+    double core_run_ua; // Executing
+    double core_idle_ua; // Between ticks (16F1823 WDT sleep, 18F45K20 IDLE)
+    double core_sleep_ua; // SLEEP waiting for nAWAKE
+    double tick_usec; // Tick period, USEC_PER_TICK of the target
+    double tick_run_usec; // Executing per tick
+    bool pwm_spin; // Core runs for as long as the speaker sounds
+
+    // ADXL362
+    double accel_measure_ua;
+    double accel_wakeup_ua;
+    double accel_standby_ua;
+
+    // Board
+    double regulator_ua; // ADP160 quiescent
+    double speaker_ua; // Buzzer coil and Q3 base while sounding
+    double led_ua; // Each LED while lit
+    double int_ua; // Each of INT1/INT2 while high, Q1/Q2 base drive
+
+} energy_table_t, *energy_table_ptr_t;
+
+/*
+ * Charge per component, microamp seconds.
+ */
+typedef struct _energy_t
+{
+    double core;
+    double accel;
+    double regulator;
+    double speaker;
+    double leds;
+    double ints;
+    double total;
+    double active; // Core executing, seconds
+    double spin; // core had it spun between ticks (IDLE_MODE_SPIN)
+    double seconds; // Span integrated
+
+} energy_t, *energy_ptr_t;
+
+// Current tables, ENERGY_NUM_TARGETS entries
+#define ENERGY_NUM_TARGETS (2)
+extern const energy_table_t energy_tables[ENERGY_NUM_TARGETS];
+
+/* ************************************************************************** */
+/*!
+ \ingroup energy
+
+ \brief energy_integrate
+
+ Integrates the current table over the statistics of a simulation.
+
+ \param[in] table - current table.
+ \param[in] stats - simulation statistics.
+ \param[in] usec - span the statistics cover.
+ \param[out] energy - charge per component.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void energy_integrate(energy_table_t const * table, sim_stats_t const * stats,
+        uint64_t usec, energy_ptr_t energy);
+
+/* ************************************************************************** */
+/*!
+ \ingroup energy
+
+ \brief energy_mah_per_day
+
+ Converts a charge to an average drain.
+
+ \param[in] energy - charge.
+ \param[in] uas - component charge in microamp seconds.
+
+ \return double - mAh per day.
+
+ */
+/* ************************************************************************** */
+
+double energy_mah_per_day(energy_t const * energy, double uas);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ENERGY_H_ */
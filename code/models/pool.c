@@ -0,0 +1,177 @@
+/*
+ ==============================================================================
+ Name        : pool.c
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+// fork() and mmap() are POSIX, MAP_ANONYMOUS is not strictly so
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+// Standard includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define POOL_FORK
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+// Module include
+#include "pool.h"
+
+// Local declarations
+
+static void pool_share(pool_job_t job, void * context, uint32_t num_jobs,
+        uint8_t * results, size_t size, uint32_t worker, uint32_t workers);
+
+// Implementation
+
+/*! \brief pool_share
+ *
+ * Runs the jobs of one worker.
+ */
+static void pool_share(pool_job_t job, void * context, uint32_t num_jobs,
+        uint8_t * results, size_t size, uint32_t worker, uint32_t workers)
+{
+    uint32_t index;
+
+    for (index = worker; index < num_jobs; index += workers)
+    {
+        job(context, index, results + ((size_t) index * size));
+    }
+
+    return;
+}
+
+/*! \brief pool_workers
+ */
+uint32_t pool_workers(void)
+{
+    uint32_t workers = 1;
+#if defined(POOL_FORK)
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (online > 1)
+    {
+        workers = (uint32_t) online;
+    }
+#endif
+
+    return workers;
+}
+
+/*! \brief pool_run
+ */
+bool pool_run(pool_job_t job, void * context, uint32_t num_jobs,
+        void * results, size_t size, uint32_t workers)
+{
+#if defined(POOL_FORK)
+    uint8_t * shared;
+    size_t length = (size_t) num_jobs * size;
+    uint32_t started;
+    uint32_t worker;
+    pid_t pid;
+    int status;
+    bool ok = true;
+
+    if (workers > num_jobs)
+    {
+        workers = num_jobs;
+    }
+    if (workers <= 1)
+    {
+        pool_share(job, context, num_jobs, results, size, 0, 1);
+        return true;
+    }
+
+    shared = mmap(NULL, length, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED)
+    {
+        pool_share(job, context, num_jobs, results, size, 0, 1);
+        return true;
+    }
+
+    for (started = 0; started < workers; started++)
+    {
+        pid = fork();
+        if (pid == 0)
+        {
+            pool_share(job, context, num_jobs, shared, size, started, workers);
+            _exit(0);
+        }
+        if (pid < 0)
+        {
+            ok = false;
+            break;
+        }
+    }
+
+    // Reap every worker started
+    for (worker = 0; worker < started; worker++)
+    {
+        if ((wait(&status) < 0) || (WIFEXITED(status) == 0)
+                || (WEXITSTATUS(status) != 0))
+        {
+            ok = false;
+        }
+    }
+
+    memcpy(results, shared, length);
+    munmap(shared, length);
+
+    return ok;
+#else
+    (void) workers;
+    pool_share(job, context, num_jobs, results, size, 0, 1);
+
+    return true;
+#endif
+}
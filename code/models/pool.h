@@ -0,0 +1,116 @@
+/*
+ ==============================================================================
+ Name        : pool.h
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+#ifndef POOL_H_
+#define POOL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************** */
+/*!
+ \defgroup pool
+
+ \brief These APIs and definitions are for the model worker pool.
+
+ Runs a batch of independent jobs over all cores. The firmware keeps its
+ state in statics, so each worker is a forked process running its share of
+ the jobs one after the other, and results come back through memory shared
+ with the parent. Without fork() the jobs run one at a time in-process.
+ */
+/* ************************************************************************** */
+
+/*
+ * Job, fills in the result of one job index.
+ */
+typedef void (*pool_job_t)(void * context, uint32_t index, void * result);
+
+/* ************************************************************************** */
+/*!
+ \ingroup pool
+
+ \brief pool_workers
+
+ Default number of workers, one per online processor.
+
+ \return Number of workers, at least one.
+
+ */
+/* ************************************************************************** */
+
+uint32_t pool_workers(void);
+
+/* ************************************************************************** */
+/*!
+ \ingroup pool
+
+ \brief pool_run
+
+ Runs jobs 0 to num_jobs - 1, worker w running jobs w, w + workers, ...
+
+ \param[in] job - job to run.
+ \param[in] context - job context, shared read-only by the workers.
+ \param[in] num_jobs - number of jobs.
+ \param[out] results - num_jobs results of size bytes each.
+ \param[in] size - result size.
+ \param[in] workers - number of workers.
+
+ \return true if every job ran, false if a worker failed.
+
+ */
+/* ************************************************************************** */
+
+bool pool_run(pool_job_t job, void * context, uint32_t num_jobs,
+        void * results, size_t size, uint32_t workers);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POOL_H_ */
@@ -0,0 +1,302 @@
+/*
+ ==============================================================================
+ Name        : replay.c
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+// Host includes
+#include <registers.h>
+
+// Other includes
+#include "adxl362_model.h"
+#include "sim.h"
+#include "energy.h"
+
+// Module include
+#include "replay.h"
+
+// Local declarations
+
+#define USEC_PER_SEC (1000000ULL)
+
+#define REPLAY_LINE_MAX (256)
+
+/*
+ * Alerts seen against the last motion of a trace.
+ */
+typedef struct _replay_alerts_t
+{
+    uint64_t last_motion;
+    uint64_t first; // First alert at or after the last motion
+    uint32_t early; // Alerts before the last motion
+    bool detected;
+
+} replay_alerts_t, *replay_alerts_ptr_t;
+
+static bool trace_sample(void * context, uint64_t * time, int16_t xyz[3]);
+static uint64_t trace_last_motion(trace_t const * trace, int32_t motion);
+static void replay_observe(void * context, uint64_t now, uint8_t state);
+
+// Implementation
+
+/*! \brief trace_load
+ *
+ * Reads "time_sec x_mg y_mg z_mg" lines, '#' starts a comment.
+ */
+bool trace_load(char const * path, trace_ptr_t trace)
+{
+    char line[REPLAY_LINE_MAX];
+    size_t size = 0;
+    double sec;
+    double mg[3];
+    uint64_t time;
+    char * text;
+    void * grown;
+    FILE * file;
+    bool ok = true;
+    int i;
+
+    memset(trace, 0, sizeof(*trace));
+
+    file = fopen(path, "r");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    while ((ok == true) && (fgets(line, sizeof(line), file) != NULL))
+    {
+        text = line + strspn(line, " \t");
+        if ((*text == '#') || (*text == '\n') || (*text == '\r')
+                || (*text == '\0'))
+        {
+            continue;
+        }
+
+        if ((sscanf(text, "%lf %lf %lf %lf", &sec, &mg[0], &mg[1], &mg[2])
+                != 4) || (sec < 0))
+        {
+            ok = false;
+            break;
+        }
+
+        // Samples in time order
+        time = (uint64_t) llround(sec * USEC_PER_SEC);
+        if ((trace->count > 0) && (time < trace->time[trace->count - 1]))
+        {
+            ok = false;
+            break;
+        }
+
+        if (trace->count == size)
+        {
+            size = (size == 0) ? 1024 : (size * 2);
+            grown = realloc(trace->time, size * sizeof(*trace->time));
+            ok = (grown != NULL);
+            if (ok == true)
+            {
+                trace->time = grown;
+                grown = realloc(trace->xyz, size * sizeof(*trace->xyz));
+                ok = (grown != NULL);
+            }
+            if (ok == false)
+            {
+                break;
+            }
+            trace->xyz = grown;
+        }
+
+        trace->time[trace->count] = time;
+        for (i = 0; i < 3; i++)
+        {
+            mg[i] = (mg[i] > INT16_MAX) ? INT16_MAX : mg[i];
+            mg[i] = (mg[i] < INT16_MIN) ? INT16_MIN : mg[i];
+            trace->xyz[trace->count][i] = (int16_t) lround(mg[i]);
+        }
+        trace->count++;
+    }
+
+    fclose(file);
+
+    if ((ok == false) || (trace->count == 0))
+    {
+        trace_free(trace);
+        return false;
+    }
+
+    return true;
+}
+
+/*! \brief trace_free
+ */
+void trace_free(trace_ptr_t trace)
+{
+    free(trace->time);
+    free(trace->xyz);
+    memset(trace, 0, sizeof(*trace));
+
+    return;
+}
+
+/*! \brief trace_sample
+ */
+static bool trace_sample(void * context, uint64_t * time, int16_t xyz[3])
+{
+    trace_ptr_t trace = context;
+
+    if (trace->next >= trace->count)
+    {
+        return false;
+    }
+
+    *time = trace->offset + trace->time[trace->next];
+    memcpy(xyz, trace->xyz[trace->next], sizeof(trace->xyz[0]));
+    trace->next++;
+
+    return true;
+}
+
+/*! \brief trace_last_motion
+ *
+ * Time of the last sample further than the motion threshold from where the
+ * recording comes to rest, the start of the recording if there is none.
+ */
+static uint64_t trace_last_motion(trace_t const * trace, int32_t motion)
+{
+    int16_t const * rest = trace->xyz[trace->count - 1];
+    int32_t delta;
+    size_t n;
+    int i;
+
+    for (n = trace->count; n-- > 0;)
+    {
+        for (i = 0; i < 3; i++)
+        {
+            delta = (int32_t) trace->xyz[n][i] - rest[i];
+            if ((delta > motion) || (-delta > motion))
+            {
+                return trace->time[n];
+            }
+        }
+    }
+
+    return trace->time[0];
+}
+
+/*! \brief replay_observe
+ */
+static void replay_observe(void * context, uint64_t now, uint8_t state)
+{
+    replay_alerts_ptr_t alerts = context;
+
+    if (state != SIM_STATE_ALERT)
+    {
+        return;
+    }
+
+    if (now < alerts->last_motion)
+    {
+        alerts->early++;
+    }
+    else if (alerts->detected == false)
+    {
+        alerts->first = now;
+        alerts->detected = true;
+    }
+
+    return;
+}
+
+/*! \brief replay_run
+ */
+void replay_run(replay_t const * replay, trace_t const * trace,
+        replay_result_ptr_t result)
+{
+    static sim_t sim;
+    replay_alerts_t alerts;
+    energy_t energy;
+    trace_t play = *trace;
+
+    memset(result, 0, sizeof(*result));
+
+    play.next = 0;
+    play.offset = replay->lead;
+
+    memset(&alerts, 0, sizeof(alerts));
+    alerts.last_motion = play.offset
+            + trace_last_motion(&play, replay->motion);
+
+    sim_init(&sim, play.offset + play.time[play.count - 1] + replay->tail);
+    adxl362_model_init_samples(&sim.accel, trace_sample, &play);
+    sim.observer = replay_observe;
+    sim.context = &alerts;
+    sim_run(&sim);
+
+    energy_integrate(&energy_tables[replay->target], &sim.stats, sim.now,
+            &energy);
+
+    result->loaded = true;
+    result->samples = (uint32_t) play.count;
+    result->seconds = (double) play.time[play.count - 1] / USEC_PER_SEC;
+    result->last_motion = (double) (alerts.last_motion - play.offset)
+            / USEC_PER_SEC;
+    result->alerts = sim.stats.alerts;
+    result->false_alerts = alerts.early;
+    result->detected = alerts.detected;
+    result->latency = (double) (alerts.first - alerts.last_motion)
+            / USEC_PER_SEC;
+    result->uah = energy.total / 3600.0;
+    result->mah_per_day = energy_mah_per_day(&energy, energy.total);
+
+    return;
+}
@@ -0,0 +1,172 @@
+/*
+ ==============================================================================
+ Name        : replay.h
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************** */
+/*!
+ \defgroup replay
+
+ \brief These APIs and definitions are for replaying recorded traces.
+
+ A trace is text, one sample per line: time in seconds from the start of
+ the recording, then X, Y and Z in mg; '#' starts a comment. A replay runs
+ the controller on the simulator with the trace driving the accelerometer
+ model, and scores the alerts against the last motion of the recording.
+ Times are in microseconds.
+ */
+/* ************************************************************************** */
+
+/*
+ * Recorded trace, samples at their time from the start of the recording.
+ */
+typedef struct _trace_t
+{
+    uint64_t * time;
+    int16_t (*xyz)[3];
+    size_t count;
+    size_t next; // Next sample replayed
+    uint64_t offset; // Time the recording starts after power-up
+
+} trace_t, *trace_ptr_t;
+
+/*
+ * Replay settings.
+ */
+typedef struct _replay_t
+{
+    uint64_t lead; // Power-up to the start of the recording
+    uint64_t tail; // Replayed past the end of the recording
+    int32_t motion; // Change from the final rest that is motion, mg
+    int target; // Energy table
+
+} replay_t, *replay_ptr_t;
+
+/*
+ * Result of one replay.
+ */
+typedef struct _replay_result_t
+{
+    bool loaded;
+    uint32_t samples;
+    double seconds; // Recording length
+    double last_motion; // Into the recording
+    uint32_t alerts;
+    uint32_t false_alerts; // Alerts before the last motion
+    bool detected; // Alert at or after the last motion
+    double latency; // Last motion to the alert
+    double uah; // Charge over the replay
+    double mah_per_day;
+
+} replay_result_t, *replay_result_ptr_t;
+
+/* ************************************************************************** */
+/*!
+ \ingroup replay
+
+ \brief trace_load
+
+ Reads a trace file.
+
+ \param[in] path - trace file.
+ \param[out] trace - trace, release with trace_free().
+
+ \return true if the file holds at least one sample in time order.
+
+ */
+/* ************************************************************************** */
+
+bool trace_load(char const * path, trace_ptr_t trace);
+
+/* ************************************************************************** */
+/*!
+ \ingroup replay
+
+ \brief trace_free
+
+ Releases a loaded trace.
+
+ \param[in] trace - trace to release.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void trace_free(trace_ptr_t trace);
+
+/* ************************************************************************** */
+/*!
+ \ingroup replay
+
+ \brief replay_run
+
+ Replays a trace through the controller with the current host settings.
+
+ \param[in] replay - replay settings.
+ \param[in] trace - loaded trace, left unchanged.
+ \param[out] result - alerts and energy.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void replay_run(replay_t const * replay, trace_t const * trace,
+        replay_result_ptr_t result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* REPLAY_H_ */
@@ -0,0 +1,244 @@
+/*
+ ==============================================================================
+ Name        : replay_main.c
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// clock_gettime() is POSIX, not C99
+#define _POSIX_C_SOURCE 200809L
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+// Host includes
+#include <registers.h>
+#include "../pic/wake_on_sleep.X/user.h"
+
+// Other includes
+#include "adxl362.h"
+#include "adxl362_model.h"
+#include "sim.h"
+#include "energy.h"
+#include "pool.h"
+#include "replay.h"
+
+// Local declarations
+
+#define USEC_PER_SEC (1000000ULL)
+
+/*
+ * Replay job context, shared by every worker.
+ */
+typedef struct _replay_batch_t
+{
+    char * const * files;
+    replay_t replay;
+
+} replay_batch_t, *replay_batch_ptr_t;
+
+static void replay_job(void * context, uint32_t index, void * result);
+static void usage(char const * name);
+
+// Implementation
+
+/*! \brief replay_job
+ *
+ * Replays one trace through the controller.
+ */
+static void replay_job(void * context, uint32_t index, void * result)
+{
+    replay_batch_ptr_t batch = context;
+    replay_result_ptr_t out = result;
+    trace_t trace;
+
+    memset(out, 0, sizeof(*out));
+
+    if (trace_load(batch->files[index], &trace) == true)
+    {
+        replay_run(&batch->replay, &trace, out);
+        trace_free(&trace);
+    }
+
+    return;
+}
+
+/*! \brief usage
+ */
+static void usage(char const * name)
+{
+    fprintf(stderr,
+            "usage: %s [-j workers] [-t target] [-m motion_mg] [-p lead_sec] "
+                    "[-w tail_sec] trace...\n"
+                    "  -j  parallel workers (default one per processor)\n"
+                    "  -t  energy table, 0 PIC16F1823, 1 PIC18F45K20 "
+                    "(default 0)\n"
+                    "  -m  change from the final rest that counts as motion "
+                    "(default THRESH_ACT)\n"
+                    "  -p  power-up to the start of each trace (default 2 s)\n"
+                    "  -w  replayed past the end of each trace "
+                    "(default 60 s)\n"
+                    "trace: lines of \"time_sec x_mg y_mg z_mg\", "
+                    "'#' comments\n", name);
+
+    return;
+}
+
+/*! \brief main
+ */
+int main(int argc, char * argv[])
+{
+    replay_batch_t batch;
+    replay_result_ptr_t results;
+    replay_result_ptr_t r;
+    uint32_t workers = pool_workers();
+    uint32_t num_traces;
+    uint32_t failed = 0;
+    uint32_t alerts = 0;
+    uint32_t false_alerts = 0;
+    uint32_t missed = 0;
+    struct timespec started;
+    struct timespec stopped;
+    double seconds;
+    bool ok;
+    int i;
+
+    memset(&batch, 0, sizeof(batch));
+    batch.replay.lead = 2 * USEC_PER_SEC;
+    batch.replay.tail = 60 * USEC_PER_SEC;
+    batch.replay.motion = adxl362_params.thresh_act;
+
+    for (i = 1; (i < argc) && (argv[i][0] == '-'); i++)
+    {
+        if ((i + 1 < argc) && (strcmp(argv[i], "-j") == 0))
+        {
+            workers = strtoul(argv[++i], NULL, 0);
+        }
+        else if ((i + 1 < argc) && (strcmp(argv[i], "-t") == 0))
+        {
+            batch.replay.target = atoi(argv[++i]);
+        }
+        else if ((i + 1 < argc) && (strcmp(argv[i], "-m") == 0))
+        {
+            batch.replay.motion = atoi(argv[++i]);
+        }
+        else if ((i + 1 < argc) && (strcmp(argv[i], "-p") == 0))
+        {
+            batch.replay.lead = atof(argv[++i]) * USEC_PER_SEC;
+        }
+        else if ((i + 1 < argc) && (strcmp(argv[i], "-w") == 0))
+        {
+            batch.replay.tail = atof(argv[++i]) * USEC_PER_SEC;
+        }
+        else
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if ((i == argc) || (workers == 0) || (batch.replay.motion < 0)
+            || (batch.replay.target < 0) || (batch.replay.target >= ENERGY_NUM_TARGETS))
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    batch.files = &argv[i];
+    num_traces = (uint32_t) (argc - i);
+    results = calloc(num_traces, sizeof(*results));
+    if (results == NULL)
+    {
+        return EXIT_FAILURE;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &started);
+    ok = pool_run(replay_job, &batch, num_traces, results, sizeof(*results),
+            workers);
+    clock_gettime(CLOCK_MONOTONIC, &stopped);
+    seconds = (stopped.tv_sec - started.tv_sec)
+            + (stopped.tv_nsec - started.tv_nsec) / 1e9;
+
+    printf("%-32s %8s %8s %6s %6s %9s %10s %10s\n", "trace", "length_s",
+            "motion_s", "alerts", "false", "latency_s", "uAh", "mAh/day");
+
+    for (i = 0; i < (int) num_traces; i++)
+    {
+        r = &results[i];
+        if (r->loaded == false)
+        {
+            printf("%-32s unreadable\n", batch.files[i]);
+            failed++;
+            continue;
+        }
+
+        alerts += r->alerts;
+        false_alerts += r->false_alerts;
+        if (r->detected == false)
+        {
+            missed++;
+            printf("%-32s %8.1f %8.1f %6u %6u %9s %10.3f %10.4f\n",
+                    batch.files[i], r->seconds, r->last_motion, r->alerts,
+                    r->false_alerts, "missed", r->uah, r->mah_per_day);
+        }
+        else
+        {
+            printf("%-32s %8.1f %8.1f %6u %6u %9.2f %10.3f %10.4f\n",
+                    batch.files[i], r->seconds, r->last_motion, r->alerts,
+                    r->false_alerts, r->latency, r->uah, r->mah_per_day);
+        }
+    }
+
+    printf("%u traces (%u unreadable), %u alerts, %u false, %u missed, "
+            "%s energy, %.3f s on %u workers\n", num_traces, failed, alerts,
+            false_alerts, missed, energy_tables[batch.replay.target].name, seconds,
+            workers);
+
+    free(results);
+
+    return ((ok == true) && (failed == 0)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,379 @@
+/*
+ ==============================================================================
+ Name        : sim.c
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+// Standard includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+// Host includes
+#include <registers.h>
+#include "../pic/wake_on_sleep.X/user.h"
+
+// Other includes
+#include "adxl362.h"
+#include "pwm.h"
+#include "sw_timer.h"
+#include "event.h"
+#include "wake_on_sleep.h"
+#include "adxl362_model.h"
+
+// Module include
+#include "sim.h"
+
+// Local declarations
+
+#if (ADXL362_FIFO_MODE != ADXL362_FIFO_OFF)
+#error The simulator drives nAWAKE from AWAKE, build with the FIFO off.
+#endif
+
+#if (SPI_DRIVER != SPI_DRIVER_HOST)
+#error The simulator needs SPI_DRIVER_HOST.
+#endif
+
+#define SIM_SKIP_MAX (SW_TIMER_NONE - 1)
+
+#define SIM_AUTOSLEEP (1 << 2) // POWER_CTL
+
+static void sim_account(uint64_t usec);
+static bool sim_timer_expired(void);
+static void sim_timer_reset(void);
+static void sim_sleep(void);
+static bool sim_nawake(void);
+static void sim_nawake_clear(void);
+static void sim_spi_select(bool selected);
+static uint8_t sim_spi_xchg(uint8_t data);
+static uint16_t sim_adc_fvr(void);
+static uint64_t sim_idle_ticks(sim_ptr_t sim);
+
+static const host_hooks_t sim_hooks =
+{ sim_timer_expired, sim_timer_reset, sim_sleep, sim_nawake,
+        sim_nawake_clear, sim_spi_select, sim_spi_xchg, sim_adc_fvr };
+
+// The simulation in progress
+static sim_ptr_t sim_active;
+
+// Implementation
+
+/*! \brief sim_account
+ *
+ * Advances virtual time, charging it to the current outputs.
+ */
+static void sim_account(uint64_t usec)
+{
+    sim_ptr_t sim = sim_active;
+    adxl362_model_ptr_t accel = &sim->accel;
+
+    sim->stats.state_usec[sim->state] += usec;
+    if (host_registers.tmr2on == 1)
+    {
+        sim->stats.pwm_usec += usec;
+        sim->stats.speaker_usec += (usec * host_registers.pwm_duty)
+                / PWM_DUTY_MAX;
+    }
+    if (HEARTBEAT_PORT & HEARTBEAT)
+    {
+        sim->stats.heartbeat_usec += usec;
+    }
+    if (STATE_PORT & SB0)
+    {
+        sim->stats.sb0_usec += usec;
+    }
+    if (STATE_PORT & SB1)
+    {
+        sim->stats.sb1_usec += usec;
+    }
+
+    // Accelerometer power mode and interrupt pins
+    adxl362_model_update(accel, sim->now);
+    if (accel->measuring == true)
+    {
+        if ((accel->awake == false)
+                && (accel->regs[ADXL362_REG_POWER_CTL] & SIM_AUTOSLEEP))
+        {
+            sim->stats.wakeup_usec += usec;
+        }
+        else
+        {
+            sim->stats.measure_usec += usec;
+        }
+    }
+    if (adxl362_model_int(accel, ADXL362_REG_INTMAP1) == true)
+    {
+        sim->stats.int1_usec += usec;
+    }
+    if (adxl362_model_int(accel, ADXL362_REG_INTMAP2) == true)
+    {
+        sim->stats.int2_usec += usec;
+    }
+
+    sim->now += usec;
+
+    return;
+}
+
+/*! \brief sim_timer_expired
+ *
+ * Each poll is the next tick.
+ */
+static bool sim_timer_expired(void)
+{
+    sim_account(USEC_PER_TICK);
+    sim_active->stats.ticks++;
+
+    return true;
+}
+
+/*! \brief sim_timer_reset
+ */
+static void sim_timer_reset(void)
+{
+    return;
+}
+
+/*! \brief sim_sleep
+ *
+ * Jumps to the next rising edge of nAWAKE, the end of the simulation if
+ * there is none. An edge since the last nAWAKE_CLEAR wakes at once, and so
+ * does the tick left enabled: a Timer0 flag is never more than a tick from
+ * being set, so it is taken as pending.
+ */
+static void sim_sleep(void)
+{
+    sim_ptr_t sim = sim_active;
+    uint64_t edge;
+
+    sim->tick_woke = (host_registers.tmr0ie == 1);
+    if (sim->tick_woke == true)
+    {
+        sim->stats.tick_wakes++;
+        return;
+    }
+
+    adxl362_model_update(&sim->accel, sim->now);
+
+    while (sim->accel.asleep_edge <= sim->cleared)
+    {
+        edge = adxl362_model_next_edge(&sim->accel);
+        if (edge > sim->end)
+        {
+            edge = sim->end;
+        }
+
+        sim->stats.sleep_usec += edge - sim->now;
+        sim_account(edge - sim->now);
+
+        if (sim->now >= sim->end)
+        {
+            return;
+        }
+
+        adxl362_model_update(&sim->accel, sim->now);
+    }
+
+    sim->stats.wakes++;
+
+    return;
+}
+
+/*! \brief sim_nawake
+ *
+ * nAWAKE is wired to INT2.
+ */
+static bool sim_nawake(void)
+{
+    adxl362_model_update(&sim_active->accel, sim_active->now);
+
+    return adxl362_model_int(&sim_active->accel, ADXL362_REG_INTMAP2);
+}
+
+/*! \brief sim_nawake_clear
+ */
+static void sim_nawake_clear(void)
+{
+    sim_active->cleared = sim_active->now;
+
+    return;
+}
+
+/*! \brief sim_spi_select
+ */
+static void sim_spi_select(bool selected)
+{
+    if (selected == true)
+    {
+        SPI_nCS_PORT &= ~nCS;
+    }
+    else
+    {
+        SPI_nCS_PORT |= nCS;
+    }
+    adxl362_model_select(&sim_active->accel, selected);
+
+    return;
+}
+
+/*! \brief sim_spi_xchg
+ */
+static uint8_t sim_spi_xchg(uint8_t data)
+{
+    return adxl362_model_xchg(&sim_active->accel, sim_active->now, data);
+}
+
+/*! \brief sim_adc_fvr
+ */
+static uint16_t sim_adc_fvr(void)
+{
+    return ((uint32_t) FVR_MV * 1023) / sim_active->vdd_mv;
+}
+
+/*! \brief sim_idle_ticks
+ *
+ * Number of following ticks in which no timer expires and the accelerometer
+ * does not change, the controller would only count them.
+ */
+static uint64_t sim_idle_ticks(sim_ptr_t sim)
+{
+    uint64_t ticks = sw_timer_next();
+    uint64_t edge;
+    uint64_t limit;
+
+    // The tick a timer expires on must run
+    ticks = ((ticks == SW_TIMER_NONE) || (ticks == 0)) ?
+            SIM_SKIP_MAX : (ticks - 1);
+
+    // So must the first tick that sees the accelerometer change
+    adxl362_model_update(&sim->accel, sim->now);
+    edge = adxl362_model_next_edge(&sim->accel);
+    if (edge != ADXL362_MODEL_NEVER)
+    {
+        limit = (edge - sim->now - 1) / USEC_PER_TICK;
+        if (limit < ticks)
+        {
+            ticks = limit;
+        }
+    }
+
+    // Never past the end
+    limit = (sim->end - sim->now) / USEC_PER_TICK;
+    if (limit < ticks)
+    {
+        ticks = limit;
+    }
+
+    return ticks;
+}
+
+/*! \brief sim_init
+ */
+void sim_init(sim_ptr_t sim, uint64_t duration)
+{
+    memset(sim, 0, sizeof(*sim));
+    sim->end = duration;
+    sim->state = SIM_STATE_INIT;
+    sim->vdd_mv = SIM_VDD_MV;
+    adxl362_model_init(&sim->accel, NULL, NULL);
+
+    return;
+}
+
+/*! \brief sim_run
+ */
+void sim_run(sim_ptr_t sim)
+{
+    uint8_t previous = SIM_NUM_STATES;
+    uint64_t ticks;
+
+    sim_active = sim;
+
+    host_reset();
+    host_hooks = sim_hooks;
+
+    wake_on_sleep_init();
+
+    while (sim->now < sim->end)
+    {
+        // A state entered on the last tick runs its entry on this one, an
+        // event posted with the tick is handled before time moves on
+        if ((sim->state == previous) && (event_pending() == false))
+        {
+            ticks = sim_idle_ticks(sim);
+            if (ticks > 0)
+            {
+                sw_timer_skip((uint16_t) ticks);
+                sim_account(ticks * USEC_PER_TICK);
+                sim->stats.skipped += ticks;
+                continue;
+            }
+        }
+        previous = sim->state;
+
+        wake_on_sleep_tick();
+
+        sim->state = wake_on_sleep_state();
+        if ((sim->state != previous) && (sim->now < sim->end))
+        {
+            if (sim->state == SIM_STATE_ALERT)
+            {
+                sim->stats.alerts++;
+                if (sim->tick_woke == true)
+                {
+                    sim->stats.tick_alerts++;
+                }
+            }
+            if (sim->observer != NULL)
+            {
+                sim->observer(sim->context, sim->now, sim->state);
+            }
+        }
+    }
+
+    sim_active = NULL;
+
+    return;
+}
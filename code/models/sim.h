@@ -0,0 +1,170 @@
+/*
+ ==============================================================================
+ Name        : sim.h
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************** */
+/*!
+ \defgroup sim
+
+ \brief These APIs and definitions are for the virtual-time simulator.
+
+ The simulator runs the unchanged controller of a host build on virtual
+ time. Ticks run the controller exactly as main() does, but spans in which
+ no software timer expires and the accelerometer does not change are
+ skipped in one step, and SLEEP() jumps straight to the next nAWAKE wake-up
+ edge. The firmware keeps its state in statics, so one simulation runs per
+ process at a time. Times are in microseconds.
+ */
+/* ************************************************************************** */
+
+// Controller states, see wake_on_sleep_state()
+#define SIM_STATE_SLEEP     (0)
+#define SIM_STATE_INIT      (1)
+#define SIM_STATE_ALERT     (2)
+#define SIM_STATE_EOL       (3)
+#define SIM_NUM_STATES      (4)
+
+// Battery unless set, a fresh CR2032
+#define SIM_VDD_MV          (3000)
+
+/*
+ * Simulation statistics.
+ */
+typedef struct _sim_stats_t
+{
+    uint64_t state_usec[SIM_NUM_STATES]; // Time in each controller state
+    uint64_t sleep_usec; // Core in SLEEP, part of the sleep state
+    uint64_t pwm_usec; // Speaker driven
+    uint64_t speaker_usec; // pwm_usec scaled by duty, 1/2 duty counts 1:1
+    uint64_t heartbeat_usec; // Heart beat LED on
+    uint64_t sb0_usec; // State bit 0 LED on
+    uint64_t sb1_usec; // State bit 1 LED on
+    uint64_t measure_usec; // Accelerometer measuring at the full rate
+    uint64_t wakeup_usec; // Accelerometer asleep in wake-up mode
+    uint64_t int1_usec; // INT1 high
+    uint64_t int2_usec; // INT2 high
+    uint64_t ticks; // Ticks the controller ran
+    uint64_t skipped; // Idle ticks skipped
+    uint32_t alerts; // Entries into the alert state
+    uint32_t wakes; // Wake-ups from SLEEP
+    uint32_t tick_wakes; // SLEEP() ended at once by a pending tick
+    uint32_t tick_alerts; // Alerts with no nAWAKE edge, after a tick_wake
+
+} sim_stats_t, *sim_stats_ptr_t;
+
+/*
+ * State change observer, called with the time a state was entered.
+ */
+typedef void (*sim_observer_t)(void * context, uint64_t now, uint8_t state);
+
+/*
+ * Simulator definition.
+ */
+typedef struct _sim_t
+{
+    uint64_t now;
+    uint64_t end;
+    uint64_t cleared; // Time of the last nAWAKE_CLEAR
+    uint16_t vdd_mv; // Battery, read by the FVR conversion
+    uint8_t state;
+    bool tick_woke; // The last SLEEP() ended on the tick
+    adxl362_model_t accel;
+    sim_stats_t stats;
+    sim_observer_t observer;
+    void * context; // Observer context
+
+} sim_t, *sim_ptr_t;
+
+/* ************************************************************************** */
+/*!
+ \ingroup sim
+
+ \brief sim_init
+
+ Prepares a simulation. The accelerometer model starts without motion, it
+ may be initialized again with a motion or sample source, and an observer
+ set, before the simulation runs.
+
+ \param[out] sim - simulator to initialize.
+ \param[in] duration - virtual time to run.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void sim_init(sim_ptr_t sim, uint64_t duration);
+
+/* ************************************************************************** */
+/*!
+ \ingroup sim
+
+ \brief sim_run
+
+ Powers up the device and runs the controller for a span of virtual time.
+
+ \param[in,out] sim - initialized simulator, holds the statistics on return.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void sim_run(sim_ptr_t sim);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_H_ */
@@ -0,0 +1,347 @@
+/*
+ ==============================================================================
+ Name        : sim_main.c
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+// Host includes
+#include <registers.h>
+#include "../pic/wake_on_sleep.X/user.h"
+
+// Other includes
+#include "adxl362_model.h"
+#include "sim.h"
+#include "energy.h"
+
+// Local declarations
+
+#define USEC_PER_SEC (1000000ULL)
+#define SEC_PER_DAY (86400ULL)
+
+/*
+ * Play scenario: sessions of motion at random intervals, each interval
+ * and session length uniform between half and one and a half of its mean.
+ * No interval is no motion at all.
+ */
+typedef struct _play_t
+{
+    char const * name;
+    uint64_t interval;
+    uint64_t length;
+    uint64_t time;
+    uint32_t seed;
+
+} play_t, *play_ptr_t;
+
+/*
+ * Usage scenarios for the energy table (-e).
+ */
+static const play_t scenarios[] =
+{
+{ "shelf", 0, 0, 0, 0 },
+{ "daily", SEC_PER_DAY * USEC_PER_SEC, 300 * USEC_PER_SEC, 0, 0 },
+{ "hourly", 3600 * USEC_PER_SEC, 120 * USEC_PER_SEC, 0, 0 },
+{ "busy", 600 * USEC_PER_SEC, 60 * USEC_PER_SEC, 0, 0 } };
+
+static uint64_t play_uniform(play_ptr_t play, uint64_t mean);
+static bool play_motion(void * context, uint64_t * start, uint64_t * end);
+static void report(sim_ptr_t sim, double seconds);
+static void report_energy(play_t const * scenario, uint32_t seed, double days);
+static void usage(char const * name);
+
+// Implementation
+
+/*! \brief play_uniform
+ */
+static uint64_t play_uniform(play_ptr_t play, uint64_t mean)
+{
+    // xorshift32
+    play->seed ^= play->seed << 13;
+    play->seed ^= play->seed >> 17;
+    play->seed ^= play->seed << 5;
+
+    return (mean / 2) + ((mean * (play->seed >> 16)) >> 16);
+}
+
+/*! \brief play_motion
+ */
+static bool play_motion(void * context, uint64_t * start, uint64_t * end)
+{
+    play_ptr_t play = context;
+
+    if (play->interval == 0)
+    {
+        return false;
+    }
+
+    play->time += play_uniform(play, play->interval);
+    *start = play->time;
+    play->time += play_uniform(play, play->length);
+    *end = play->time;
+
+    return true;
+}
+
+/*! \brief report
+ */
+static void report(sim_ptr_t sim, double seconds)
+{
+    energy_t energy;
+    uint64_t ticks = sim->now / USEC_PER_TICK;
+    double sleep = (double) sim->stats.sleep_usec / USEC_PER_SEC;
+    double total = (double) sim->now;
+    int i;
+
+    printf("simulated  : %.3f days, %llu ticks of %u usec\n",
+            total / (SEC_PER_DAY * USEC_PER_SEC), (unsigned long long) ticks,
+            (unsigned) USEC_PER_TICK);
+    printf("ticks      : %llu run, %llu skipped, %.1f%% of time in SLEEP\n",
+            (unsigned long long) sim->stats.ticks,
+            (unsigned long long) sim->stats.skipped,
+            100.0 * sim->stats.sleep_usec / total);
+    printf("cpu time   : %.3f s, %.3g simulated ticks/s\n", seconds,
+            (seconds > 0) ? (ticks / seconds) : 0.0);
+    printf("alerts     : %u, %u wake-ups, %u ended by the tick (%u alerts)\n",
+            sim->stats.alerts, sim->stats.wakes, sim->stats.tick_wakes,
+            sim->stats.tick_alerts);
+    printf("states     : sleep %.2f%%, init %.4f%%, alert %.4f%%, "
+            "end of life %.2f%%\n",
+            100.0 * sim->stats.state_usec[SIM_STATE_SLEEP] / total,
+            100.0 * sim->stats.state_usec[SIM_STATE_INIT] / total,
+            100.0 * sim->stats.state_usec[SIM_STATE_ALERT] / total,
+            100.0 * sim->stats.state_usec[SIM_STATE_EOL] / total);
+    printf("outputs    : speaker %.4f%%, heart beat %.4f%%, "
+            "SB0 %.4f%%, SB1 %.4f%%\n",
+            100.0 * sim->stats.pwm_usec / total,
+            100.0 * sim->stats.heartbeat_usec / total,
+            100.0 * sim->stats.sb0_usec / total,
+            100.0 * sim->stats.sb1_usec / total);
+
+    // Energy per target
+    for (i = 0; i < ENERGY_NUM_TARGETS; i++)
+    {
+        energy_integrate(&energy_tables[i], &sim->stats, sim->now, &energy);
+        printf("%-11s: %.4f mAh/day (core %.4f, accel %.4f, regulator %.4f, "
+                "speaker %.4f, leds %.4f, int %.4f), %.0f days on a CR2032, "
+                "%.0f without the INT1/INT2 base drive\n",
+                energy_tables[i].name, energy_mah_per_day(&energy, energy.total),
+                energy_mah_per_day(&energy, energy.core),
+                energy_mah_per_day(&energy, energy.accel),
+                energy_mah_per_day(&energy, energy.regulator),
+                energy_mah_per_day(&energy, energy.speaker),
+                energy_mah_per_day(&energy, energy.leds),
+                energy_mah_per_day(&energy, energy.ints),
+                ENERGY_CR2032_MAH / energy_mah_per_day(&energy, energy.total),
+                ENERGY_CR2032_MAH / energy_mah_per_day(&energy,
+                        energy.total - energy.ints));
+        printf("%-11s: core executing %.2f%% of the %.2f h out of SLEEP, "
+                "core %.4f mAh/day, %.4f spinning (IDLE_MODE_SPIN)\n", "",
+                (energy.seconds > sleep) ?
+                        (100.0 * energy.active / (energy.seconds - sleep)) :
+                        0.0, (energy.seconds - sleep) / 3600.0,
+                energy_mah_per_day(&energy, energy.core),
+                energy_mah_per_day(&energy, energy.spin));
+    }
+
+    return;
+}
+
+/*! \brief report_energy
+ *
+ * One line per usage scenario and target.
+ */
+static void report_energy(play_t const * scenario, uint32_t seed, double days)
+{
+    static sim_t sim;
+    play_t play;
+    energy_t energy;
+    double mah;
+    size_t i;
+    int j;
+
+    printf("%-8s %-12s %10s %10s %10s %10s\n", "scenario", "target",
+            "alerts/day", "mAh/day", "days", "days-int");
+
+    for (i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+    {
+        play = scenario[i];
+        play.seed = seed;
+        sim_init(&sim, days * SEC_PER_DAY * USEC_PER_SEC);
+        adxl362_model_init(&sim.accel, play_motion, &play);
+        sim_run(&sim);
+
+        for (j = 0; j < ENERGY_NUM_TARGETS; j++)
+        {
+            energy_integrate(&energy_tables[j], &sim.stats, sim.now, &energy);
+            mah = energy_mah_per_day(&energy, energy.total);
+            printf("%-8s %-12s %10.2f %10.4f %10.0f %10.0f\n", play.name,
+                    energy_tables[j].name, sim.stats.alerts / days, mah,
+                    ENERGY_CR2032_MAH / mah, ENERGY_CR2032_MAH
+                            / energy_mah_per_day(&energy,
+                                    energy.total - energy.ints));
+        }
+    }
+
+    return;
+}
+
+/*! \brief usage
+ */
+static void usage(char const * name)
+{
+    fprintf(stderr,
+            "usage: %s [-d days] [-i interval_sec] [-l length_sec] [-s seed] "
+                    "[-v vdd_mv] [-e] [-c]\n"
+                    "  -d  virtual time to simulate (default 30 days)\n"
+                    "  -i  mean time between play sessions, 0 for none "
+                    "(default 3600 s)\n"
+                    "  -l  mean play session length (default 120 s)\n"
+                    "  -s  random seed (default 1)\n"
+                    "  -v  battery voltage (default 3000 mV)\n"
+                    "  -e  energy table of the usage scenarios instead\n"
+                    "  -c  fail if SLEEP() ended on a pending tick, with no "
+                    "nAWAKE edge\n",
+            name);
+
+    return;
+}
+
+/*! \brief main
+ */
+int main(int argc, char * argv[])
+{
+    static sim_t sim;
+    play_t play;
+    double days = 30.0;
+    uint16_t vdd_mv = SIM_VDD_MV;
+    double seconds;
+    bool energy = false;
+    bool check = false;
+    clock_t started;
+    int i;
+
+    memset(&play, 0, sizeof(play));
+    play.interval = 3600 * USEC_PER_SEC;
+    play.length = 120 * USEC_PER_SEC;
+    play.seed = 1;
+
+    for (i = 1; i < argc; i++)
+    {
+        if ((i + 1 < argc) && (strcmp(argv[i], "-d") == 0))
+        {
+            days = atof(argv[++i]);
+        }
+        else if ((i + 1 < argc) && (strcmp(argv[i], "-i") == 0))
+        {
+            play.interval = atof(argv[++i]) * USEC_PER_SEC;
+        }
+        else if ((i + 1 < argc) && (strcmp(argv[i], "-l") == 0))
+        {
+            play.length = atof(argv[++i]) * USEC_PER_SEC;
+        }
+        else if ((i + 1 < argc) && (strcmp(argv[i], "-s") == 0))
+        {
+            play.seed = strtoul(argv[++i], NULL, 0);
+        }
+        else if ((i + 1 < argc) && (strcmp(argv[i], "-v") == 0))
+        {
+            vdd_mv = strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "-e") == 0)
+        {
+            energy = true;
+        }
+        else if (strcmp(argv[i], "-c") == 0)
+        {
+            check = true;
+        }
+        else
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if ((days <= 0) || (play.seed == 0) || (vdd_mv == 0))
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (energy == true)
+    {
+        report_energy(scenarios, play.seed, days);
+    }
+    else
+    {
+        sim_init(&sim, days * SEC_PER_DAY * USEC_PER_SEC);
+        adxl362_model_init(&sim.accel, play_motion, &play);
+        sim.vdd_mv = vdd_mv;
+
+        started = clock();
+        sim_run(&sim);
+        seconds = (double) (clock() - started) / CLOCKS_PER_SEC;
+
+        report(&sim, seconds);
+
+        // A deep sleep must hold until nAWAKE, whatever the tick
+        if ((check == true) && (sim.stats.tick_wakes > 0))
+        {
+            fprintf(stderr, "check failed: %u SLEEP() ended on the tick, "
+                    "%u of them went to alert\n", sim.stats.tick_wakes,
+                    sim.stats.tick_alerts);
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,631 @@
+/*
+ ==============================================================================
+ Name        : sweep_main.c
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// clock_gettime() is POSIX, not C99
+#define _POSIX_C_SOURCE 200809L
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+// Host includes
+#include <registers.h>
+#include "../pic/wake_on_sleep.X/user.h"
+
+// Other includes
+#include "adxl362.h"
+#include "wake_on_sleep.h"
+#include "adxl362_model.h"
+#include "sim.h"
+#include "energy.h"
+#include "pool.h"
+#include "replay.h"
+
+// Local declarations
+
+#define USEC_PER_SEC (1000000ULL)
+#define USEC_PER_MSEC (1000)
+
+#define SWEEP_NAME_MAX (32)
+
+// Swept parameters
+#define SWEEP_THRESH_ACT    (0)
+#define SWEEP_THRESH_INACT  (1)
+#define SWEEP_TIME_ACT      (2)
+#define SWEEP_TIME_INACT    (3)
+#define SWEEP_ALERT_TIMEOUT (4)
+#define SWEEP_SLEEP_WAIT    (5)
+#define SWEEP_NUM_AXES      (6)
+
+// Timeouts run on 16-bit tick counts
+#define SWEEP_TIMEOUT_MIN   ((double) USEC_PER_TICK / USEC_PER_MSEC)
+#define SWEEP_TIMEOUT_MAX   (65534.0 * USEC_PER_TICK / USEC_PER_MSEC)
+
+/*
+ * Sweep axis, a parameter and the range it is swept over.
+ */
+typedef struct _sweep_axis_t
+{
+    char const * name;
+    char const * unit;
+    double min; // Allowed range
+    double max;
+    double lo; // Swept range, lo alone if not swept
+    double hi;
+    uint32_t steps;
+
+} sweep_axis_t, *sweep_axis_ptr_t;
+
+/*
+ * Parameter set.
+ */
+typedef struct _sweep_config_t
+{
+    double value[SWEEP_NUM_AXES];
+
+} sweep_config_t, *sweep_config_ptr_t;
+
+/*
+ * Score of one parameter set over the corpus.
+ */
+typedef struct _sweep_result_t
+{
+    double false_rate; // False alerts per trace
+    double missed_rate; // Traces without an alert after the last motion
+    double latency; // Mean latency of the alerts that came
+    double mah_per_day; // Mean drain
+    bool pareto;
+
+} sweep_result_t, *sweep_result_ptr_t;
+
+/*
+ * Sweep job context, shared by every worker.
+ */
+typedef struct _sweep_t
+{
+    sweep_config_t const * configs;
+    trace_t const * traces;
+    uint32_t num_traces;
+    replay_t replay;
+
+} sweep_t, *sweep_ptr_t;
+
+static sweep_axis_t sweep_axes[SWEEP_NUM_AXES] =
+{
+{ "thresh_act", "mg", 0, 2047, 0, 0, 1 },
+{ "thresh_inact", "mg", 0, 2047, 0, 0, 1 },
+{ "time_act", "samples", 0, 255, 0, 0, 1 },
+{ "time_inact", "samples", 0, 65535, 0, 0, 1 },
+{ "alert_timeout", "ms", SWEEP_TIMEOUT_MIN, SWEEP_TIMEOUT_MAX, 0, 0, 1 },
+{ "sleep_wait", "ms", SWEEP_TIMEOUT_MIN, SWEEP_TIMEOUT_MAX, 0, 0, 1 } };
+
+static uint32_t sweep_random(uint32_t * seed);
+static bool sweep_axis(char const * spec);
+static sweep_config_ptr_t sweep_grid(uint32_t * num_configs);
+static sweep_config_ptr_t sweep_lhs(uint32_t num_configs, uint32_t seed);
+static void sweep_apply(sweep_config_t const * config);
+static void sweep_job(void * context, uint32_t index, void * result);
+static bool sweep_dominates(sweep_result_t const * a,
+        sweep_result_t const * b);
+static void sweep_pareto(sweep_result_ptr_t results, uint32_t num_configs);
+static void usage(char const * name);
+
+// Implementation
+
+/*! \brief sweep_random
+ */
+static uint32_t sweep_random(uint32_t * seed)
+{
+    // xorshift32
+    *seed ^= *seed << 13;
+    *seed ^= *seed >> 17;
+    *seed ^= *seed << 5;
+
+    return *seed;
+}
+
+/*! \brief sweep_axis
+ *
+ * Parses "name=lo:hi[:steps]" into the swept range of an axis.
+ */
+static bool sweep_axis(char const * spec)
+{
+    char name[SWEEP_NAME_MAX];
+    double lo;
+    double hi;
+    unsigned steps = 2;
+    int fields;
+    int i;
+
+    fields = sscanf(spec, "%31[^=]=%lf:%lf:%u", name, &lo, &hi, &steps);
+    if (fields < 3)
+    {
+        return false;
+    }
+
+    for (i = 0; i < SWEEP_NUM_AXES; i++)
+    {
+        if (strcmp(name, sweep_axes[i].name) == 0)
+        {
+            if ((lo > hi) || (lo < sweep_axes[i].min)
+                    || (hi > sweep_axes[i].max) || (steps == 0))
+            {
+                return false;
+            }
+            sweep_axes[i].lo = lo;
+            sweep_axes[i].hi = hi;
+            sweep_axes[i].steps = (lo == hi) ? 1 : steps;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*! \brief sweep_grid
+ *
+ * Cartesian product of the axes, the first axis varying fastest.
+ */
+static sweep_config_ptr_t sweep_grid(uint32_t * num_configs)
+{
+    sweep_config_ptr_t configs;
+    sweep_axis_ptr_t axis;
+    uint64_t total = 1;
+    uint32_t index;
+    uint32_t rest;
+    uint32_t step;
+    int i;
+
+    for (i = 0; i < SWEEP_NUM_AXES; i++)
+    {
+        total *= sweep_axes[i].steps;
+        if (total > UINT32_MAX)
+        {
+            return NULL;
+        }
+    }
+
+    configs = calloc(total, sizeof(*configs));
+    if (configs == NULL)
+    {
+        return NULL;
+    }
+
+    for (index = 0; index < total; index++)
+    {
+        rest = index;
+        for (i = 0; i < SWEEP_NUM_AXES; i++)
+        {
+            axis = &sweep_axes[i];
+            step = rest % axis->steps;
+            rest /= axis->steps;
+            configs[index].value[i] = (axis->steps == 1) ? axis->lo :
+                    axis->lo + (axis->hi - axis->lo) * step / (axis->steps - 1);
+        }
+    }
+
+    *num_configs = (uint32_t) total;
+
+    return configs;
+}
+
+/*! \brief sweep_lhs
+ *
+ * Latin hypercube, each swept axis split into num_configs strata and every
+ * stratum sampled once.
+ */
+static sweep_config_ptr_t sweep_lhs(uint32_t num_configs, uint32_t seed)
+{
+    sweep_config_ptr_t configs;
+    sweep_axis_ptr_t axis;
+    uint32_t * strata;
+    uint32_t swap;
+    uint32_t index;
+    uint32_t j;
+    double u;
+    int i;
+
+    configs = calloc(num_configs, sizeof(*configs));
+    strata = calloc(num_configs, sizeof(*strata));
+    if ((configs == NULL) || (strata == NULL))
+    {
+        free(configs);
+        free(strata);
+        return NULL;
+    }
+
+    for (i = 0; i < SWEEP_NUM_AXES; i++)
+    {
+        axis = &sweep_axes[i];
+
+        // Shuffle the strata, Fisher-Yates
+        for (index = 0; index < num_configs; index++)
+        {
+            strata[index] = index;
+        }
+        for (index = num_configs; index > 1; index--)
+        {
+            j = sweep_random(&seed) % index;
+            swap = strata[index - 1];
+            strata[index - 1] = strata[j];
+            strata[j] = swap;
+        }
+
+        for (index = 0; index < num_configs; index++)
+        {
+            u = (strata[index] + (sweep_random(&seed) >> 8) / 16777216.0)
+                    / num_configs;
+            configs[index].value[i] = (axis->steps == 1) ? axis->lo :
+                    axis->lo + (axis->hi - axis->lo) * u;
+        }
+    }
+
+    free(strata);
+
+    return configs;
+}
+
+/*! \brief sweep_apply
+ *
+ * Sets the host parameters, programmed at the next power-up.
+ */
+static void sweep_apply(sweep_config_t const * config)
+{
+    double const * value = config->value;
+
+    adxl362_params.thresh_act = (uint16_t) lround(value[SWEEP_THRESH_ACT]);
+    adxl362_params.thresh_inact = (uint16_t) lround(
+            value[SWEEP_THRESH_INACT]);
+    adxl362_params.time_act = (uint8_t) lround(value[SWEEP_TIME_ACT]);
+    adxl362_params.time_inact = (uint16_t) lround(value[SWEEP_TIME_INACT]);
+    wake_on_sleep_params.alert_timeout_usec = (uint32_t) lround(
+            value[SWEEP_ALERT_TIMEOUT] * USEC_PER_MSEC);
+    wake_on_sleep_params.sleep_wait_usec = (uint32_t) lround(
+            value[SWEEP_SLEEP_WAIT] * USEC_PER_MSEC);
+
+    return;
+}
+
+/*! \brief sweep_job
+ *
+ * Replays the corpus with one parameter set.
+ */
+static void sweep_job(void * context, uint32_t index, void * result)
+{
+    sweep_ptr_t sweep = context;
+    sweep_result_ptr_t out = result;
+    replay_result_t replay;
+    uint32_t false_alerts = 0;
+    uint32_t missed = 0;
+    double latency = 0;
+    double mah = 0;
+    uint32_t i;
+
+    sweep_apply(&sweep->configs[index]);
+
+    for (i = 0; i < sweep->num_traces; i++)
+    {
+        replay_run(&sweep->replay, &sweep->traces[i], &replay);
+
+        false_alerts += replay.false_alerts;
+        mah += replay.mah_per_day;
+        if (replay.detected == true)
+        {
+            latency += replay.latency;
+        }
+        else
+        {
+            missed++;
+        }
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->false_rate = (double) false_alerts / sweep->num_traces;
+    out->missed_rate = (double) missed / sweep->num_traces;
+    out->latency = (missed < sweep->num_traces) ?
+            (latency / (sweep->num_traces - missed)) : 0;
+    out->mah_per_day = mah / sweep->num_traces;
+
+    return;
+}
+
+/*! \brief sweep_dominates
+ *
+ * No worse on every objective and better on one.
+ */
+static bool sweep_dominates(sweep_result_t const * a,
+        sweep_result_t const * b)
+{
+    if ((a->false_rate > b->false_rate) || (a->missed_rate > b->missed_rate)
+            || (a->mah_per_day > b->mah_per_day))
+    {
+        return false;
+    }
+
+    return (a->false_rate < b->false_rate) || (a->missed_rate < b->missed_rate)
+            || (a->mah_per_day < b->mah_per_day);
+}
+
+/*! \brief sweep_pareto
+ *
+ * Marks the parameter sets no other set dominates.
+ */
+static void sweep_pareto(sweep_result_ptr_t results, uint32_t num_configs)
+{
+    uint32_t i;
+    uint32_t j;
+
+    for (i = 0; i < num_configs; i++)
+    {
+        results[i].pareto = true;
+        for (j = 0; j < num_configs; j++)
+        {
+            if ((j != i) && (sweep_dominates(&results[j], &results[i]) == true))
+            {
+                results[i].pareto = false;
+                break;
+            }
+        }
+    }
+
+    return;
+}
+
+/*! \brief usage
+ */
+static void usage(char const * name)
+{
+    int i;
+
+    fprintf(stderr,
+            "usage: %s [-x axis=lo:hi[:steps]]... [-l configs] [-s seed] "
+                    "[-a] [-j workers] [-t target] [-m motion_mg] "
+                    "[-p lead_sec] [-w tail_sec] trace...\n"
+                    "  -x  sweep an axis, steps for the grid (default 2)\n"
+                    "  -l  Latin hypercube of this many sets instead of "
+                    "the grid\n"
+                    "  -s  Latin hypercube seed (default 1)\n"
+                    "  -a  every set, not only the Pareto front\n"
+                    "  -j  parallel workers (default one per processor)\n"
+                    "  -t  energy table, 0 PIC16F1823, 1 PIC18F45K20 "
+                    "(default 0)\n"
+                    "  -m  change from the final rest that counts as motion "
+                    "(default THRESH_ACT)\n"
+                    "  -p  power-up to the start of each trace (default 2 s)\n"
+                    "  -w  replayed past the end of each trace "
+                    "(default 60 s)\n"
+                    "axes:\n", name);
+    for (i = 0; i < SWEEP_NUM_AXES; i++)
+    {
+        fprintf(stderr, "  %-14s %g..%g %s, default %g\n", sweep_axes[i].name,
+                sweep_axes[i].min, sweep_axes[i].max, sweep_axes[i].unit,
+                sweep_axes[i].lo);
+    }
+
+    return;
+}
+
+/*! \brief main
+ */
+int main(int argc, char * argv[])
+{
+    sweep_t sweep;
+    sweep_config_ptr_t configs = NULL;
+    sweep_result_ptr_t results = NULL;
+    trace_ptr_t traces = NULL;
+    uint32_t workers = pool_workers();
+    uint32_t num_configs = 0;
+    uint32_t num_pareto = 0;
+    uint32_t seed = 1;
+    uint32_t index;
+    struct timespec started;
+    struct timespec stopped;
+    double seconds;
+    bool all = false;
+    bool ok = false;
+    int i;
+    int j;
+
+    // The firmware defaults are the unswept values
+    sweep_axes[SWEEP_THRESH_ACT].lo = adxl362_params.thresh_act;
+    sweep_axes[SWEEP_THRESH_INACT].lo = adxl362_params.thresh_inact;
+    sweep_axes[SWEEP_TIME_ACT].lo = adxl362_params.time_act;
+    sweep_axes[SWEEP_TIME_INACT].lo = adxl362_params.time_inact;
+    sweep_axes[SWEEP_ALERT_TIMEOUT].lo =
+            (double) wake_on_sleep_params.alert_timeout_usec / USEC_PER_MSEC;
+    sweep_axes[SWEEP_SLEEP_WAIT].lo = (double) wake_on_sleep_params
+            .sleep_wait_usec / USEC_PER_MSEC;
+    for (i = 0; i < SWEEP_NUM_AXES; i++)
+    {
+        sweep_axes[i].hi = sweep_axes[i].lo;
+    }
+
+    memset(&sweep, 0, sizeof(sweep));
+    sweep.replay.lead = 2 * USEC_PER_SEC;
+    sweep.replay.tail = 60 * USEC_PER_SEC;
+    sweep.replay.motion = adxl362_params.thresh_act;
+
+    for (i = 1; (i < argc) && (argv[i][0] == '-'); i++)
+    {
+        if ((i + 1 < argc) && (strcmp(argv[i], "-x") == 0))
+        {
+            if (sweep_axis(argv[++i]) == false)
+            {
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if ((i + 1 < argc) && (strcmp(argv[i], "-l") == 0))
+        {
+            num_configs = strtoul(argv[++i], NULL, 0);
+        }
+        else if ((i + 1 < argc) && (strcmp(argv[i], "-s") == 0))
+        {
+            seed = strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "-a") == 0)
+        {
+            all = true;
+        }
+        else if ((i + 1 < argc) && (strcmp(argv[i], "-j") == 0))
+        {
+            workers = strtoul(argv[++i], NULL, 0);
+        }
+        else if ((i + 1 < argc) && (strcmp(argv[i], "-t") == 0))
+        {
+            sweep.replay.target = atoi(argv[++i]);
+        }
+        else if ((i + 1 < argc) && (strcmp(argv[i], "-m") == 0))
+        {
+            sweep.replay.motion = atoi(argv[++i]);
+        }
+        else if ((i + 1 < argc) && (strcmp(argv[i], "-p") == 0))
+        {
+            sweep.replay.lead = atof(argv[++i]) * USEC_PER_SEC;
+        }
+        else if ((i + 1 < argc) && (strcmp(argv[i], "-w") == 0))
+        {
+            sweep.replay.tail = atof(argv[++i]) * USEC_PER_SEC;
+        }
+        else
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if ((i == argc) || (workers == 0) || (seed == 0)
+            || (sweep.replay.motion < 0) || (sweep.replay.target < 0)
+            || (sweep.replay.target >= ENERGY_NUM_TARGETS))
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Every worker replays the whole corpus, load it once
+    sweep.num_traces = (uint32_t) (argc - i);
+    traces = calloc(sweep.num_traces, sizeof(*traces));
+    if (traces == NULL)
+    {
+        return EXIT_FAILURE;
+    }
+    for (j = 0; j < (int) sweep.num_traces; j++)
+    {
+        if (trace_load(argv[i + j], &traces[j]) == false)
+        {
+            fprintf(stderr, "%s: unreadable trace\n", argv[i + j]);
+            goto done;
+        }
+    }
+    sweep.traces = traces;
+
+    configs = (num_configs > 0) ?
+            sweep_lhs(num_configs, seed) : sweep_grid(&num_configs);
+    results = calloc(num_configs, sizeof(*results));
+    if ((configs == NULL) || (results == NULL))
+    {
+        goto done;
+    }
+    sweep.configs = configs;
+
+    clock_gettime(CLOCK_MONOTONIC, &started);
+    ok = pool_run(sweep_job, &sweep, num_configs, results, sizeof(*results),
+            workers);
+    clock_gettime(CLOCK_MONOTONIC, &stopped);
+    seconds = (stopped.tv_sec - started.tv_sec)
+            + (stopped.tv_nsec - started.tv_nsec) / 1e9;
+
+    sweep_pareto(results, num_configs);
+
+    for (j = 0; j < SWEEP_NUM_AXES; j++)
+    {
+        printf("%14s ", sweep_axes[j].name);
+    }
+    printf("%10s %10s %10s %10s %s\n", "false/tr", "missed", "latency_s",
+            "mAh/day", "pareto");
+
+    for (index = 0; index < num_configs; index++)
+    {
+        if (results[index].pareto == true)
+        {
+            num_pareto++;
+        }
+        else if (all == false)
+        {
+            continue;
+        }
+
+        for (j = 0; j < SWEEP_NUM_AXES; j++)
+        {
+            printf("%14.0f ", configs[index].value[j]);
+        }
+        printf("%10.3f %10.3f %10.2f %10.4f %s\n", results[index].false_rate,
+                results[index].missed_rate, results[index].latency,
+                results[index].mah_per_day,
+                (results[index].pareto == true) ? "*" : "");
+    }
+
+    printf("%u sets x %u traces, %u on the Pareto front, %s energy, "
+            "%.3f s on %u workers\n", num_configs, sweep.num_traces,
+            num_pareto, energy_tables[sweep.replay.target].name, seconds,
+            workers);
+
+done:
+    for (j = 0; j < (int) sweep.num_traces; j++)
+    {
+        trace_free(&traces[j]);
+    }
+    free(traces);
+    free(configs);
+    free(results);
+
+    return (ok == true) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -51,34 +51,49 @@
 #include <htc.h>       /* HiTech General Include File */
 #elif defined(__18CXX)
 #include <p18cxxx.h>   /* C18 General Include File */
-#elif defined(__MINGW32__)
-#include <stdint.h>
-#include <registers.h>   /* x86 Dummy Include File */
+#elif defined(__MINGW32__) || defined(__unix__) || defined(__APPLE__)
+#include <registers.h> /* Host Register File */
 #endif
 
-#if defined(__XC) || defined(HI_TECH_C) || defined (__MINGW32__)
+#if defined(__XC) || defined(HI_TECH_C) || defined (HOST_BUILD)
 
 #include <stdint.h>        /* For uint8_t definition */
 #include <stdbool.h>       /* For true/false definition */
 
 #endif
 
+#include <stddef.h>
+
 // GPIO Includes
 #include "user.h"
 
+// Other includes
+#include "clock.h"
+#include "pwm.h"
+
 // Module include
 #include "adxl362.h"
 
 // Local declarations
 
 #define SPI_NUM_BITS (8)    // Use 8-bit words
+
+/* SPI bursts on the fast clock, not while a tone sounds: a level switch
+   reloads its period and duty mid-tone */
+#define ADXL362_BURST_LEVEL (pwm_is_on() ? CLOCK_RUN : CLOCK_FAST)
 /* ADXL362 communication commands */
 #define ADXL362_WRITE_REG           	0x0A
-
-/* Registers */
-#define ADXL362_REG_SOFT_RESET          0x1F
-#define ADXL362_REG_THRESH_ACT_L        0x20
-#define ADXL362_REG_POWER_CTL           0x2D
+#define ADXL362_READ_REG                0x0B
+#define ADXL362_READ_FIFO               0x0D
+
+/* SPI chip select */
+#if (SPI_DRIVER == SPI_DRIVER_HOST)
+#define ADXL362_SELECT      host_hooks.spi_select(true)
+#define ADXL362_DESELECT    host_hooks.spi_select(false)
+#else
+#define ADXL362_SELECT      (SPI_nCS_PORT &= ~nCS) // Active-low
+#define ADXL362_DESELECT    (SPI_nCS_PORT |= nCS) // Inactive, active-low
+#endif
 
 /* ADXL362 Reset settings */
 #define ADXL362_RESET_KEY               0x52
@@ -89,100 +104,383 @@
 /* ADXL362 Autosleep */
 #define ADXL362_AUTOSLEEP               (1 << 2)
 
+/* ADXL362 Power control, measuring, the profile adds its noise mode */
+#if defined (ADXL362_AUTONOMOUS)
+#define ADXL362_POWER_CTL               (ADXL362_MEASURE | ADXL362_AUTOSLEEP)
+#else
+#define ADXL362_POWER_CTL               (ADXL362_MEASURE)
+#endif
+#define ADXL362_WAKEUP                  (1 << 3)
+#define ADXL362_LOW_NOISE               (1 << 4)
+
+/* ADXL362 Filter control, +/-2g, bandwidth ODR/4 */
+#define ADXL362_HALF_BW                 (1 << 4)
+#define ADXL362_ODR_12_5HZ              (0)
+#define ADXL362_ODR_50HZ                (2)
+#define ADXL362_ODR_100HZ               (3)
+
+/* ADXL362 Interrupt maps */
+#define ADXL362_INT_FIFO_WATERMARK      (1 << 2)
+#define ADXL362_INT_AWAKE               (1 << 6)
+#define ADXL362_INT_LOW                 (1 << 7)
+
+/* ADXL362 FIFO configuration */
+#if (ADXL362_FIFO_MODE == ADXL362_FIFO_OFF)
+#define ADXL362_FIFO_CONTROL    (0x00)
+#define ADXL362_FIFO_SAMPLES    (0x80) // Reset default, unused
+#define ADXL362_INTMAP2         (ADXL362_INT_LOW | ADXL362_INT_AWAKE)
+#else
+#if (ADXL362_FIFO_WATERMARK < 3) || (ADXL362_FIFO_WATERMARK > 511)
+#error ADXL362_FIFO_WATERMARK must be 3..511 entries.
+#endif
+#define ADXL362_FIFO_AH         (((ADXL362_FIFO_WATERMARK) > 255) ? (1 << 3) : 0)
+#define ADXL362_FIFO_CONTROL    (ADXL362_FIFO_AH | ADXL362_FIFO_MODE)
+#define ADXL362_FIFO_SAMPLES    LOW_BYTE(ADXL362_FIFO_WATERMARK)
+// Active high, nAWAKE rises once a batch is ready
+#define ADXL362_INTMAP2         (ADXL362_INT_FIFO_WATERMARK)
+#endif
+
 // NOTE: range +/-2g
 #define ADXL362_THRESH_ACT             (125)    // 125mg
 #define ADXL362_THRESH_INACT           (250)    // 250mg
-// NOTE: sample rate 12.5Hz
-#define ADXL363_TIME_ACT                (15)    // counts (~1.2 sec)
-#define ADXL363_TIME_INACT             (125)    // counts (~10 sec)
+// NOTE: counted in samples, see adxl362_profiles
+#define ADXL362_TIME_ACT_MSEC          (1200)   // ~1.2 sec
+#define ADXL362_TIME_INACT_MSEC       (10000)   // ~10 sec
+
+// Samples in a time at a sample rate in mHz, rounded
+#define ADXL362_SAMPLES(msec, mhz) \
+    ((((uint32_t) (msec) * (mhz)) + 500000L) / 1000000L)
+
+// Sample rate of a profile in mHz, wake-up mode samples about 6 times a
+// second and ignores TIME_ACT
+#define ADXL362_RATE_MHZ(profile) \
+    (((profile) == ADXL362_PROFILE_WAKEUP) ? 6000L : \
+    (((profile) == ADXL362_PROFILE_12_5HZ) ? 12500L : \
+    (((profile) == ADXL362_PROFILE_50HZ) ? 50000L : 100000L)))
+
+/*
+ * Power and latency profile, the registers and counts that depend on the
+ * sample rate.
+ */
+typedef struct _adxl362_profile_t
+{
+    uint8_t filter_ctl; // Bandwidth and output data rate
+    uint8_t power_ctl; // Noise and wake-up mode
+    uint8_t time_act; // Samples in ADXL362_TIME_ACT_MSEC
+    uint16_t time_inact; // Samples in ADXL362_TIME_INACT_MSEC
+
+} adxl362_profile_t, *adxl362_profile_ptr_t;
+
+#define ADXL362_PROFILE_ENTRY(profile, filter_ctl, power_ctl) \
+    { (filter_ctl), (power_ctl), \
+        ADXL362_SAMPLES(ADXL362_TIME_ACT_MSEC, ADXL362_RATE_MHZ(profile)), \
+        ADXL362_SAMPLES(ADXL362_TIME_INACT_MSEC, ADXL362_RATE_MHZ(profile)) }
+
+static const adxl362_profile_t adxl362_profiles[ADXL362_NUM_PROFILES] =
+{
+ADXL362_PROFILE_ENTRY(ADXL362_PROFILE_WAKEUP,
+        ADXL362_HALF_BW | ADXL362_ODR_12_5HZ, ADXL362_WAKEUP),
+ADXL362_PROFILE_ENTRY(ADXL362_PROFILE_12_5HZ,
+        ADXL362_HALF_BW | ADXL362_ODR_12_5HZ, 0),
+ADXL362_PROFILE_ENTRY(ADXL362_PROFILE_50HZ,
+        ADXL362_HALF_BW | ADXL362_ODR_50HZ, 0),
+ADXL362_PROFILE_ENTRY(ADXL362_PROFILE_100HZ_LOW_NOISE,
+        ADXL362_HALF_BW | ADXL362_ODR_100HZ, ADXL362_LOW_NOISE) };
+
+#if (ADXL362_PROFILE >= ADXL362_NUM_PROFILES)
+#error Unknown ADXL362_PROFILE.
+#endif
 
 static const uint8_t adxl362_reset_cmd[] =
 { ADXL362_WRITE_REG, ADXL362_REG_SOFT_RESET, ADXL362_RESET_KEY };
 
-static const uint8_t adxl362_config_cmd[] =
-{ ADXL362_WRITE_REG, ADXL362_REG_THRESH_ACT_L,
+// Registers kept in the shadow, the configuration block
+#define ADXL362_SHADOW_FIRST    ADXL362_REG_THRESH_ACT_L
+#define ADXL362_SHADOW_LAST     ADXL362_REG_POWER_CTL
+#define ADXL362_SHADOW_SIZE     (ADXL362_SHADOW_LAST - ADXL362_SHADOW_FIRST + 1)
+#define ADXL362_SHADOW(reg)     ((reg) - ADXL362_SHADOW_FIRST)
+#define ADXL362_DIRTY(index)    ((uint16_t) 1 << (index))
+
+// Clean registers a burst writes through rather than end, a new burst
+// costs as much again (command and address)
+#define ADXL362_BURST_GAP       (2)
 
+static const uint8_t adxl362_config[ADXL362_SHADOW_SIZE] =
+{
 /*[20]*/LOW_BYTE(ADXL362_THRESH_ACT),
 /*[21]*/HIGH_BYTE(ADXL362_THRESH_ACT),
-/*[22]*/ADXL363_TIME_ACT,
+/*[22]*/0x00, // Profile
 /*[23]*/LOW_BYTE(ADXL362_THRESH_INACT),
 /*[24]*/HIGH_BYTE(ADXL362_THRESH_INACT),
-/*[25]*/LOW_BYTE(ADXL363_TIME_INACT),
-/*[26]*/HIGH_BYTE(ADXL363_TIME_INACT),
+/*[25]*/0x00, // Profile
+/*[26]*/0x00, // Profile
 
-/*[27]*/0x3f,
-/*[28]*/0x00,
-/*[29]*/0x80,
-/*[2a]*/0x40,
-/*[2b]*/0xC0,
-/*[2c]*/0x10,
-/*[2d]*/ADXL362_MEASURE
+/*[27]*/0x3f, // Loop mode, referenced activity and inactivity
+/*[28]*/ADXL362_FIFO_CONTROL,
+/*[29]*/ADXL362_FIFO_SAMPLES,
+/*[2a]*/ADXL362_INT_AWAKE,
+/*[2b]*/ADXL362_INTMAP2,
+/*[2c]*/0x00, // Profile
+/*[2d]*/ADXL362_POWER_CTL // Profile noise mode added
 
 };
 
-static const uint8_t adxl362_autosleep_cmd[2][3] =
+// Register values after power-up and soft reset
+static const uint8_t adxl362_defaults[ADXL362_SHADOW_SIZE] =
 {
-        // Disable
-        {
-        ADXL362_WRITE_REG, ADXL362_REG_POWER_CTL,
-        ADXL362_MEASURE },
-        // Enable
-        {
-        ADXL362_WRITE_REG, ADXL362_REG_POWER_CTL,
-        ADXL362_MEASURE | ADXL362_AUTOSLEEP } };
+/*[20]*/0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+/*[27]*/0x00, 0x00, 0x80, 0x00, 0x00, 0x13, 0x00
+};
+
+// What the accelerometer holds once the dirty registers are flushed
+static uint8_t adxl362_shadow[ADXL362_SHADOW_SIZE];
+static uint16_t adxl362_dirty;
+
+static uint8_t adxl362_profile_index = ADXL362_PROFILE;
+
+#if defined (HOST_BUILD)
+adxl362_params_t adxl362_params =
+{ ADXL362_THRESH_ACT, ADXL362_THRESH_INACT,
+        ADXL362_SAMPLES(ADXL362_TIME_ACT_MSEC,
+                ADXL362_RATE_MHZ(ADXL362_PROFILE)),
+        ADXL362_SAMPLES(ADXL362_TIME_INACT_MSEC,
+                ADXL362_RATE_MHZ(ADXL362_PROFILE)) };
+#endif
 
 // Implementation
 
-static void adxl362_xfer(uint8_t const * data, uint8_t num_bytes);
+static uint8_t adxl362_xchg(uint8_t data);
+static void adxl362_xfer(uint8_t const * tx, uint8_t * rx, uint8_t num_bytes);
+static void adxl362_write(uint8_t const * cmd, uint8_t num_bytes);
+static uint8_t adxl362_config_value(uint8_t reg);
+static void adxl362_configure(void);
+#if !defined (ADXL362_COLD_BOOT)
+static bool adxl362_read_shadow(void);
+#endif
 
-/*! \brief adxl362_init
+#if (SPI_DRIVER == SPI_DRIVER_MSSP)
+
+/*! \brief adxl362_xchg
+ *
+ * MSSP version. Each byte costs about 16 instruction cycles: 8 for the
+ * shift at FOSC/4 plus the buffer load, poll and read.
  */
-static void adxl362_xfer(uint8_t const * data, uint8_t num_bytes)
+static uint8_t adxl362_xchg(uint8_t data)
 {
-    uint8_t bits, shiftOut = 0;
+    // Writing the buffer starts the shift, MSB first
+    SPI_BUF = data;
 
-    SPI_nCS_PORT &= ~nCS; // Active-low
+    // Wait for the byte clocked in while shifting out
+    while (!SPI_BUF_FULL);
 
-    // For each byte to xfer...
-    while (num_bytes--)
+    // Reading the buffer clears BF
+    return SPI_BUF;
+}
+
+#elif (SPI_DRIVER == SPI_DRIVER_HOST)
+
+/*! \brief adxl362_xchg
+ *
+ * Host version, the byte is exchanged with the accelerometer model.
+ */
+static uint8_t adxl362_xchg(uint8_t data)
+{
+    return host_hooks.spi_xchg(data);
+}
+
+#else
+
+/*! \brief adxl362_xchg
+ *
+ * GPIO version. Each bit is a test, a port write, a clock pulse and a
+ * sample of MISO, about 20 instruction cycles per bit or 160 per byte.
+ */
+static uint8_t adxl362_xchg(uint8_t data)
+{
+    uint8_t bits = SPI_NUM_BITS;
+    uint8_t shiftOut = data;
+    uint8_t shiftIn = 0;
+
+    // For each bit per byte, MSB first
+    while (bits--)
     {
-        // Initialize number of bits to xfer
-        bits = SPI_NUM_BITS;
+        // Determine bit state
+        if (shiftOut & 0x80)
+        {
+            SPI_MOSI_PORT |= MOSI; // Active
+        }
+        else
+        {
+            SPI_MOSI_PORT &= ~MOSI; // Inactive
+        }
 
-        // Initialize shift out register and consume
-        shiftOut = *data++;
+        // Next bit (MSB first)
+        shiftOut <<= 1;
+        shiftIn <<= 1;
 
-        // For each bit per byte, MSB first
-        while (bits--)
+        // Clock in data, MISO is valid while the clock is high (mode 0)
+        SPI_MCLK_PORT |= MCLK;
+        if (SPI_MISO_PORT & MISO)
         {
-            // Determine bit state
-            if (shiftOut & 0x80)
-            {
-                SPI_MOSI_PORT |= MOSI; // Active
-            }
-            else
-            {
-                SPI_MOSI_PORT &= ~MOSI; // Inactive
-            }
+            shiftIn |= 0x01;
+        }
+        SPI_MCLK_PORT &= ~MCLK;
+    }
 
-            // Clock in data
-            SPI_MCLK_PORT |= MCLK;
-            SPI_MCLK_PORT &= ~MCLK;
+    return shiftIn;
+}
 
-            // Next bit (MSB first)
-            shiftOut <<= 1;
+#endif
+
+/*! \brief adxl362_xfer
+ *
+ * Full-duplex transfer within an asserted chip select. Without a transmit
+ * buffer zeros are shifted out, without a receive buffer the data shifted
+ * in is discarded.
+ */
+static void adxl362_xfer(uint8_t const * tx, uint8_t * rx, uint8_t num_bytes)
+{
+    uint8_t shiftIn;
+
+    // For each byte to xfer...
+    while (num_bytes--)
+    {
+        shiftIn = adxl362_xchg((tx != NULL) ? *tx++ : 0x00);
+
+        if (rx != NULL)
+        {
+            *rx++ = shiftIn;
         }
     }
 
-    SPI_nCS_PORT |= nCS; // Inactive, active-low
+    return;
+}
+
+/*! \brief adxl362_write
+ */
+static void adxl362_write(uint8_t const * cmd, uint8_t num_bytes)
+{
+    uint8_t level = clock_set(ADXL362_BURST_LEVEL); // Burst on the fast clock
+
+    ADXL362_SELECT;
+    adxl362_xfer(cmd, NULL, num_bytes);
+    ADXL362_DESELECT;
+
+    clock_set(level);
 
     return;
 }
 
+/*! \brief adxl362_config_value
+ *
+ * Configured value of a shadow register, with the current profile (and on
+ * a host build the host settings) applied.
+ */
+static uint8_t adxl362_config_value(uint8_t reg)
+{
+    adxl362_profile_t const * profile =
+            &adxl362_profiles[adxl362_profile_index];
+    uint8_t value = adxl362_config[ADXL362_SHADOW(reg)];
+
+    switch (reg)
+    {
+#if defined (HOST_BUILD)
+    case ADXL362_REG_THRESH_ACT_L:
+        value = LOW_BYTE(adxl362_params.thresh_act);
+        break;
+    case ADXL362_REG_THRESH_ACT_H:
+        value = HIGH_BYTE(adxl362_params.thresh_act);
+        break;
+    case ADXL362_REG_TIME_ACT:
+        value = adxl362_params.time_act;
+        break;
+    case ADXL362_REG_THRESH_INACT_L:
+        value = LOW_BYTE(adxl362_params.thresh_inact);
+        break;
+    case ADXL362_REG_THRESH_INACT_H:
+        value = HIGH_BYTE(adxl362_params.thresh_inact);
+        break;
+    case ADXL362_REG_TIME_INACT_L:
+        value = LOW_BYTE(adxl362_params.time_inact);
+        break;
+    case ADXL362_REG_TIME_INACT_H:
+        value = HIGH_BYTE(adxl362_params.time_inact);
+        break;
+#else
+    case ADXL362_REG_TIME_ACT:
+        value = profile->time_act;
+        break;
+    case ADXL362_REG_TIME_INACT_L:
+        value = LOW_BYTE(profile->time_inact);
+        break;
+    case ADXL362_REG_TIME_INACT_H:
+        value = HIGH_BYTE(profile->time_inact);
+        break;
+#endif
+    case ADXL362_REG_FILTER_CTL:
+        value = profile->filter_ctl;
+        break;
+    case ADXL362_REG_POWER_CTL:
+        value |= profile->power_ctl;
+        break;
+    default:
+        break;
+    }
+
+    return value;
+}
+
+/*! \brief adxl362_configure
+ *
+ * Stages the configuration over the shadow, only what differs is dirty.
+ */
+static void adxl362_configure(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < ADXL362_SHADOW_SIZE; i++)
+    {
+        adxl362_stage(ADXL362_SHADOW_FIRST + i,
+                adxl362_config_value(ADXL362_SHADOW_FIRST + i));
+    }
+
+    return;
+}
+
+#if !defined (ADXL362_COLD_BOOT)
+
+/*! \brief adxl362_read_shadow
+ *
+ * Loads the shadow from the accelerometer. ERR_USER_REGS is its own check
+ * of the registers, it is set after power-up and soft reset and when a
+ * register was disturbed: the registers are not worth reading then.
+ */
+static bool adxl362_read_shadow(void)
+{
+    uint8_t status;
+
+    adxl362_read_regs(ADXL362_REG_STATUS, &status, sizeof(status));
+    if (status & ADXL362_STATUS_ERR_USER_REGS)
+    {
+        return false;
+    }
+
+    adxl362_read_regs(ADXL362_SHADOW_FIRST, adxl362_shadow,
+            sizeof(adxl362_shadow));
+    adxl362_dirty = 0;
+
+    return true;
+}
+
+#endif
+
 /*! \brief adxl362_init
  */
 void adxl362_init(void)
 {
+    bool warm = false;
+    uint8_t i;
+
     // Configure GPIO for SPI
 
     // Initialize SPI signal conditions
@@ -190,11 +488,45 @@ void adxl362_init(void)
     SPI_MCLK_PORT &= ~MCLK; // Idle
     SPI_MOSI_PORT &= ~MOSI; // Inactive
 
-    // Reset ADXL362
-    adxl362_xfer(adxl362_reset_cmd, sizeof(adxl362_reset_cmd));
+#if (SPI_DRIVER == SPI_DRIVER_MSSP)
+    // SSPxSTAT: SMP = 0, sample in the middle of the data output time
+    //           CKE = 1, transmit on the active to idle clock transition
+    SPI_STAT = 0b01000000;
 
-    // Program ADXL362 (Wake-on-Sleep)
-    adxl362_xfer(adxl362_config_cmd, sizeof(adxl362_config_cmd));
+    // SSPxCON1: SSPEN = 1, enable the MSSP and its SCK/SDO/SDI pins
+    //           CKP = 0, idle clock is low (SPI mode 0)
+    //           SSPM = 0000, SPI master, clock = FOSC/4
+    SPI_CON1 = 0b00100000;
+#endif
+
+#if !defined (ADXL362_COLD_BOOT)
+    // Warm boot (watchdog, brown-out, MCLR), an accelerometer that kept
+    // its configuration keeps measuring and its activity timing too. Only
+    // autosleep, on when the controller reset while asleep, may differ.
+    if (adxl362_read_shadow() == true)
+    {
+        adxl362_configure();
+        warm = ((adxl362_dirty
+                & ~ADXL362_DIRTY(ADXL362_SHADOW(ADXL362_REG_POWER_CTL)))
+                == 0);
+    }
+#endif
+
+    if (warm == false)
+    {
+        // Reset ADXL362
+        adxl362_write(adxl362_reset_cmd, sizeof(adxl362_reset_cmd));
+        for (i = 0; i < ADXL362_SHADOW_SIZE; i++)
+        {
+            adxl362_shadow[i] = adxl362_defaults[i];
+        }
+        adxl362_dirty = 0;
+
+        // Program ADXL362 (Wake-on-Sleep)
+        adxl362_configure();
+    }
+
+    adxl362_flush();
 
     return;
 }
@@ -205,7 +537,15 @@ bool adxl362_is_asleep(void)
 {
     bool is_asleep;
 
+#if (ADXL362_FIFO_MODE == ADXL362_FIFO_OFF)
     is_asleep = nAWAKE;
+#else
+    uint8_t status;
+
+    // nAWAKE carries the FIFO watermark, read AWAKE from the status
+    adxl362_read_regs(ADXL362_REG_STATUS, &status, sizeof(status));
+    is_asleep = ((status & ADXL362_STATUS_AWAKE) == 0);
+#endif
 
     return is_asleep;
 }
@@ -214,11 +554,176 @@ bool adxl362_is_asleep(void)
  */
 void adxl362_autosleep(bool active)
 {
-    uint8_t index = ((active == false) ? 0 : 1);
+    uint8_t power_ctl = adxl362_config_value(ADXL362_REG_POWER_CTL)
+            & ~ADXL362_AUTOSLEEP;
+
+    // Program ADXL362 (Autosleep), nothing is sent if it already is
+    adxl362_stage(ADXL362_REG_POWER_CTL,
+            (active == false) ? power_ctl : (power_ctl | ADXL362_AUTOSLEEP));
+    adxl362_flush();
+
+    return;
+}
+
+/*! \brief adxl362_profile
+ */
+void adxl362_profile(uint8_t profile)
+{
+    if ((profile >= ADXL362_NUM_PROFILES)
+            || (profile == adxl362_profile_index))
+    {
+        return;
+    }
+
+    // Standby for the change, POWER_CTL goes out last and restarts it
+    adxl362_stage(ADXL362_REG_POWER_CTL, 0x00);
+    adxl362_flush();
+
+    adxl362_profile_index = profile;
+    adxl362_configure();
+    adxl362_flush();
+
+    return;
+}
+
+/*! \brief adxl362_standby
+ */
+void adxl362_standby(void)
+{
+    // Standby with activity detection off and neither interrupt pin
+    // mapped, adxl362_init() puts the configuration back
+    adxl362_stage(ADXL362_REG_ACT_INACT_CTL, 0x00);
+    adxl362_stage(ADXL362_REG_INTMAP1, 0x00);
+    adxl362_stage(ADXL362_REG_INTMAP2, 0x00);
+    adxl362_stage(ADXL362_REG_POWER_CTL, 0x00);
+    adxl362_flush();
+
+    return;
+}
+
+/*! \brief adxl362_stage
+ */
+void adxl362_stage(uint8_t reg, uint8_t value)
+{
+    uint8_t index = ADXL362_SHADOW(reg);
+
+    if ((index < ADXL362_SHADOW_SIZE) && (adxl362_shadow[index] != value))
+    {
+        adxl362_shadow[index] = value;
+        adxl362_dirty |= ADXL362_DIRTY(index);
+    }
+
+    return;
+}
+
+/*! \brief adxl362_flush
+ */
+void adxl362_flush(void)
+{
+    uint8_t level;
+    uint8_t first;
+    uint8_t last;
+    uint8_t index;
 
-    // Program ADXL362 (Autosleep)
-    adxl362_xfer(adxl362_autosleep_cmd[index],
-            sizeof(adxl362_autosleep_cmd[index]));
+    if (adxl362_dirty == 0)
+    {
+        return;
+    }
+
+    level = clock_set(ADXL362_BURST_LEVEL); // Burst on the fast clock
+
+    // In register order, POWER_CTL (measurement) goes last
+    for (first = 0; first < ADXL362_SHADOW_SIZE; first = last + 1)
+    {
+        last = first;
+        if ((adxl362_dirty & ADXL362_DIRTY(first)) == 0)
+        {
+            continue;
+        }
+
+        // Extend the burst over the next dirty register within the gap
+        for (index = first + 1; (index < ADXL362_SHADOW_SIZE)
+                && ((index - last) <= (ADXL362_BURST_GAP + 1)); index++)
+        {
+            if (adxl362_dirty & ADXL362_DIRTY(index))
+            {
+                last = index;
+            }
+        }
+
+        ADXL362_SELECT;
+
+        // Write command and start address, the address auto-increments
+        adxl362_xchg(ADXL362_WRITE_REG);
+        adxl362_xchg(ADXL362_SHADOW_FIRST + first);
+        for (index = first; index <= last; index++)
+        {
+            adxl362_xchg(adxl362_shadow[index]);
+            adxl362_dirty &= ~ADXL362_DIRTY(index);
+        }
+
+        ADXL362_DESELECT;
+    }
+
+    clock_set(level);
 
     return;
 }
+
+/*! \brief adxl362_read_regs
+ */
+void adxl362_read_regs(uint8_t addr, uint8_t * buf, uint8_t num_bytes)
+{
+    uint8_t level = clock_set(ADXL362_BURST_LEVEL); // Burst on the fast clock
+
+    ADXL362_SELECT;
+
+    // Read command and start address, the address auto-increments
+    adxl362_xchg(ADXL362_READ_REG);
+    adxl362_xchg(addr);
+
+    adxl362_xfer(NULL, buf, num_bytes);
+
+    ADXL362_DESELECT;
+
+    clock_set(level);
+
+    return;
+}
+
+/*! \brief adxl362_fifo_drain
+ */
+uint8_t adxl362_fifo_drain(adxl362_fifo_entry_t callback)
+{
+    uint8_t regs[3]; // STATUS, FIFO_ENTRIES_L, FIFO_ENTRIES_H
+    uint16_t entries;
+    uint16_t entry;
+    uint8_t level;
+
+    adxl362_read_regs(ADXL362_REG_STATUS, regs, sizeof(regs));
+    entries = ((uint16_t) (regs[2] & 0x03) << 8) | regs[1];
+
+    level = clock_set(ADXL362_BURST_LEVEL); // Burst on the fast clock
+
+    ADXL362_SELECT;
+
+    // Read FIFO command, entries follow back-to-back LSB first
+    adxl362_xchg(ADXL362_READ_FIFO);
+
+    while (entries--)
+    {
+        entry = adxl362_xchg(0x00);
+        entry |= (uint16_t) adxl362_xchg(0x00) << 8;
+
+        if (callback != NULL)
+        {
+            callback(entry);
+        }
+    }
+
+    ADXL362_DESELECT;
+
+    clock_set(level);
+
+    return regs[0];
+}
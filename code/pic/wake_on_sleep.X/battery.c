@@ -0,0 +1,205 @@
+/*
+ ==============================================================================
+ Name        : battery.c
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// Compiler specific includes
+#if defined(__XC)
+#include <xc.h>        /* XC8 General Include File */
+#elif defined(HI_TECH_C)
+#include <htc.h>       /* HiTech General Include File */
+#elif defined(__18CXX)
+#include <p18cxxx.h>   /* C18 General Include File */
+#elif defined(__MINGW32__) || defined(__unix__) || defined(__APPLE__)
+#include <registers.h> /* Host Register File */
+#endif
+
+#if defined(__XC) || defined(HI_TECH_C) || defined (HOST_BUILD)
+
+#include <stdint.h>        /* For uint8_t definition */
+#include <stdbool.h>       /* For true/false definition */
+
+#endif
+
+// Target includes
+#include "user.h"
+
+// Module include
+#include "battery.h"
+
+// Local declarations
+
+static uint16_t battery_convert(void);
+
+uint16_t battery_count;
+
+static uint8_t battery_state = BATTERY_OK;
+static uint8_t battery_eol_readings; // In a row below BATTERY_EOL_MV
+
+// Counts above which VDD is below the threshold of the next level
+static const uint16_t battery_down[] =
+{ BATTERY_COUNT(BATTERY_LOW_MV), BATTERY_COUNT(BATTERY_CRITICAL_MV),
+        BATTERY_COUNT(BATTERY_EOL_MV) };
+
+// Counts below which VDD is back above the threshold of a level
+static const uint16_t battery_up[] =
+{ BATTERY_COUNT(BATTERY_LOW_MV + BATTERY_HYSTERESIS_MV),
+        BATTERY_COUNT(BATTERY_CRITICAL_MV + BATTERY_HYSTERESIS_MV) };
+
+// Implementation
+
+/*! \brief battery_convert
+ *
+ * One conversion of the FVR against VDD, right justified. The FVR and the
+ * ADC are turned on for it and off again, the ADC runs on its own RC
+ * clock whatever the clock level.
+ */
+static uint16_t battery_convert(void)
+{
+    uint16_t count;
+
+#if (__18F45K20 == 1) || (_18F45K20 == 1)
+
+    // CVRCON2: FVREN = 1, wait for FVRST
+    CVRCON2 = 0b10000000;
+    while (CVRCON2bits.FVRST == 0);
+
+    // ADCON1: VCFG1 = 0 (VSS), VCFG0 = 0 (VDD)
+    ADCON1 = 0b00000000;
+    // ADCON2: ADFM = 1 (right), ACQT = 111 (20 TAD), ADCS = 111 (FRC)
+    ADCON2 = 0b10111111;
+    // ADCON0: CHS = 1111 (FVR), ADON = 1
+    ADCON0 = 0b00111101;
+
+    // The acquisition time is inserted by the ADC (ACQT)
+    ADCON0bits.GO_nDONE = 1;
+    while (ADCON0bits.GO_nDONE == 1);
+    count = ((uint16_t) ADRESH << 8) | ADRESL;
+
+    ADCON0 = 0b00000000;
+    CVRCON2 = 0b00000000;
+
+#elif (__16F1823 == 1) || (_16F1823 == 1)
+
+    // FVRCON: FVREN = 1, ADFVR = 01 (1.024 V), wait for FVRRDY
+    FVRCON = 0b10000001;
+    while (FVRCONbits.FVRRDY == 0);
+
+    // ADCON1: ADFM = 1 (right), ADCS = 111 (FRC), ADPREF = 00 (VDD)
+    ADCON1 = 0b11110000;
+    // ADCON0: CHS = 11111 (FVR), ADON = 1
+    ADCON0 = 0b01111101;
+
+    // Acquisition, a few instruction cycles at 500 kHz
+    __delay_us(BATTERY_ACQ_USEC);
+    ADCON0bits.GO_nDONE = 1;
+    while (ADCON0bits.GO_nDONE == 1);
+    count = ((uint16_t) ADRESH << 8) | ADRESL;
+
+    ADCON0 = 0b00000000;
+    FVRCON = 0b00000000;
+
+#elif defined HOST_BUILD
+
+    count = host_hooks.adc_fvr();
+
+#else
+
+#error Error! You must create definitions for this processor.
+
+#endif
+
+    return count;
+}
+
+/*! \brief battery_measure
+ */
+uint8_t battery_measure(void)
+{
+    uint16_t count = battery_convert();
+
+    battery_count = count;
+
+    // End of life is kept
+    if (battery_state == BATTERY_EOL)
+    {
+        return battery_state;
+    }
+
+    // Down at once, as far as critical
+    while ((battery_state < BATTERY_CRITICAL)
+            && (count > battery_down[battery_state]))
+    {
+        battery_state++;
+    }
+
+    // Up once past the hysteresis
+    while ((battery_state > BATTERY_OK)
+            && (count < battery_up[battery_state - 1]))
+    {
+        battery_state--;
+    }
+
+    // End of life only after a few readings in a row
+    if (count > battery_down[BATTERY_CRITICAL])
+    {
+        if (++battery_eol_readings >= BATTERY_EOL_READINGS)
+        {
+            battery_state = BATTERY_EOL;
+        }
+    }
+    else
+    {
+        battery_eol_readings = 0;
+    }
+
+    return battery_state;
+}
+
+/*! \brief battery_level
+ */
+uint8_t battery_level(void)
+{
+    return battery_state;
+}
@@ -0,0 +1,387 @@
+/*
+ ==============================================================================
+ Name        : clock.c
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+// Compiler specific includes
+#if defined(__XC)
+#include <xc.h>        /* XC8 General Include File */
+#elif defined(HI_TECH_C)
+#include <htc.h>       /* HiTech General Include File */
+#elif defined(__18CXX)
+#include <p18cxxx.h>   /* C18 General Include File */
+#elif defined(__MINGW32__) || defined(__unix__) || defined(__APPLE__)
+#include <registers.h> /* Host Register File */
+#endif
+
+#if defined(__XC) || defined(HI_TECH_C) || defined (HOST_BUILD)
+
+#include <stdint.h>        /* For uint8_t definition */
+#include <stdbool.h>       /* For true/false definition */
+
+#endif
+
+// Target includes
+#include "user.h"
+#include "pwm.h"
+
+// Module include
+#include "clock.h"
+
+// Local declarations
+
+#define CLOCK_USEC_PER_SEC (1000000L)
+
+// Timer0 counts per tick, FOSC/4 through the prescaler
+#define CLOCK_TMR0_COUNTS(fosc, ps) \
+    ((((fosc) / 4 / (ps)) * (USEC_PER_TICK)) / CLOCK_USEC_PER_SEC)
+
+// Each level ticks at about twice the Timer0 counts of the one below, so
+// the part of a tick left is rescaled with a shift. Checked to within 1/32.
+#define CLOCK_TMR0_SCALES(idle, counts, shift) \
+    ((((counts) - ((idle) << (shift))) <= ((counts) / 32)) && \
+    ((((idle) << (shift)) - (counts)) <= ((counts) / 32)))
+
+// Timer2 period for a tone, rounded
+#define CLOCK_PR2(fosc, ps, freq) \
+    ((((fosc) + (2L * (ps) * (freq))) / (4L * (ps) * (freq))) - 1)
+
+// Smallest Timer2 prescaler (1, 4 or 16) that fits the period in PR2
+#define CLOCK_T2_FITS(fosc, ps, freq) (CLOCK_PR2(fosc, ps, freq) <= 255)
+#define CLOCK_T2_DIV(fosc, freq) \
+    (CLOCK_T2_FITS(fosc, 1, freq) ? 1 : \
+    (CLOCK_T2_FITS(fosc, 4, freq) ? 4 : 16))
+#define CLOCK_T2_PS(fosc, freq) \
+    (CLOCK_T2_FITS(fosc, 1, freq) ? 0b00 : \
+    (CLOCK_T2_FITS(fosc, 4, freq) ? 0b01 : 0b10))
+
+// Dead band in instruction cycles (PWM1CON P1DC), rounded up, 7 bits
+#define CLOCK_DEAD_CYCLES(fosc) \
+    ((((fosc) / 4 * PWM_DEAD_USEC) + CLOCK_USEC_PER_SEC - 1) / \
+        CLOCK_USEC_PER_SEC)
+#define CLOCK_DEAD_BAND(fosc) \
+    ((CLOCK_DEAD_CYCLES(fosc) > 127) ? 127 : CLOCK_DEAD_CYCLES(fosc))
+
+// Timer2 setup of each pitch at one level
+#define CLOCK_TONE(fosc, freq) \
+    { CLOCK_T2_PS(fosc, freq), \
+        CLOCK_PR2(fosc, CLOCK_T2_DIV(fosc, freq), freq) }
+#define CLOCK_TONES(fosc) \
+    { CLOCK_TONE(fosc, PWM_FREQ_LOW), CLOCK_TONE(fosc, PWM_FREQ_MID), \
+        CLOCK_TONE(fosc, PWM_FREQ_HIGH), CLOCK_TONE(fosc, PWM_FREQ_TOP) }
+
+/*
+ * Clock level definition.
+ */
+typedef struct _clock_level_t
+{
+    uint8_t ircf; // Internal oscillator frequency select
+    uint8_t tmr0_ps; // Timer0 prescaler select
+    uint8_t tmr0_counts; // Timer0 counts per tick
+    uint8_t tmr0_shift; // Counts are those of CLOCK_IDLE shifted left by it
+    uint8_t ready; // OSCSTAT bits set once the source runs (16F1823)
+    uint8_t dead_band; // PWM_DRIVE_HALF dead band, instruction cycles
+
+} clock_level_t, *clock_level_ptr_t;
+
+/*
+ * Tone definition, one per pitch and level.
+ */
+typedef struct _clock_tone_t
+{
+    uint8_t tmr2_ps; // Timer2 prescaler select
+    uint8_t pr2; // Tone period
+
+} clock_tone_t, *clock_tone_ptr_t;
+
+#if (__18F45K20 == 1) || (_18F45K20 == 1)
+
+#define CLOCK_TMR0 (TMR0L) // 8-bit mode
+
+// HFINTOSC / 512 (OSCTUNE INTSRC = 1), 8 MHz and 16 MHz HFINTOSC. The
+// tones are coarse at 31.25 kHz (MID is 1953 Hz), within 0.5% above.
+static const clock_level_t clock_levels[CLOCK_NUM_LEVELS] =
+{
+{ 0b000, 0b000, CLOCK_TMR0_COUNTS(31250L, 2), 0, 0,
+    CLOCK_DEAD_BAND(31250L) },
+{ 0b110, 0b111, CLOCK_TMR0_COUNTS(8000000L, 256), 1, 0,
+    CLOCK_DEAD_BAND(8000000L) },
+{ 0b111, 0b111, CLOCK_TMR0_COUNTS(16000000L, 256), 2, 0,
+    CLOCK_DEAD_BAND(16000000L) } };
+
+#if !CLOCK_TMR0_SCALES(CLOCK_TMR0_COUNTS(31250L, 2), \
+        CLOCK_TMR0_COUNTS(8000000L, 256), 1) || \
+    !CLOCK_TMR0_SCALES(CLOCK_TMR0_COUNTS(31250L, 2), \
+        CLOCK_TMR0_COUNTS(16000000L, 256), 2)
+#error Timer0 counts per tick do not double from level to level.
+#endif
+
+static const clock_tone_t clock_tones[CLOCK_NUM_LEVELS][PWM_NUM_PITCHES] =
+{ CLOCK_TONES(31250L), CLOCK_TONES(8000000L), CLOCK_TONES(16000000L) };
+
+#elif (__16F1823 == 1) || (_16F1823 == 1)
+
+#define CLOCK_TMR0 (TMR0)
+
+// OSCSTAT, oscillator ready and HFINTOSC stable
+#define CLOCK_HFIOFR (1 << 4)
+#define CLOCK_MFIOFR (1 << 2)
+#define CLOCK_LFIOFR (1 << 1)
+#define CLOCK_HFIOFS (1 << 0)
+
+// LFINTOSC (the watchdog clock), 500 kHz MFINTOSC and 4 MHz HFINTOSC. The
+// tones are coarse at 31 kHz (MID is 1937 Hz), within 2% above.
+static const clock_level_t clock_levels[CLOCK_NUM_LEVELS] =
+{
+{ 0b0000, 0b000, CLOCK_TMR0_COUNTS(31000L, 2), 0, CLOCK_LFIOFR,
+    CLOCK_DEAD_BAND(31000L) },
+{ 0b0111, 0b011, CLOCK_TMR0_COUNTS(500000L, 16), 1, CLOCK_MFIOFR,
+    CLOCK_DEAD_BAND(500000L) },
+{ 0b1101, 0b101, CLOCK_TMR0_COUNTS(4000000L, 64), 2,
+    CLOCK_HFIOFR | CLOCK_HFIOFS, CLOCK_DEAD_BAND(4000000L) } };
+
+#if !CLOCK_TMR0_SCALES(CLOCK_TMR0_COUNTS(31000L, 2), \
+        CLOCK_TMR0_COUNTS(500000L, 16), 1) || \
+    !CLOCK_TMR0_SCALES(CLOCK_TMR0_COUNTS(31000L, 2), \
+        CLOCK_TMR0_COUNTS(4000000L, 64), 2)
+#error Timer0 counts per tick do not double from level to level.
+#endif
+
+static const clock_tone_t clock_tones[CLOCK_NUM_LEVELS][PWM_NUM_PITCHES] =
+{ CLOCK_TONES(31000L), CLOCK_TONES(500000L), CLOCK_TONES(4000000L) };
+
+#elif defined HOST_BUILD
+
+// Nothing to program
+
+#else
+
+#error Error! You must create definitions for this processor.
+
+#endif
+
+static uint8_t clock_level;
+static uint8_t clock_pitch = PWM_PITCH_MID;
+
+uint8_t clock_tmr_count;
+
+static void clock_program(uint8_t level);
+#if (__18F45K20 == 1) || (_18F45K20 == 1) || \
+    (__16F1823 == 1) || (_16F1823 == 1)
+static void clock_rescale(uint8_t from, uint8_t to);
+#endif
+
+// Implementation
+
+/*! \brief clock_program
+ *
+ * Programs the oscillator and both timers for a level.
+ */
+static void clock_program(uint8_t level)
+{
+#if (__18F45K20 == 1) || (_18F45K20 == 1) || \
+    (__16F1823 == 1) || (_16F1823 == 1)
+
+    clock_level_t const * to = &clock_levels[level];
+
+    // Switch the oscillator
+    OSCCONbits.IRCF = to->ircf;
+#if (__18F45K20 == 1) || (_18F45K20 == 1)
+    while (!OSCCONbits.IOFS);
+    T0CONbits.T0PS = to->tmr0_ps;
+#else
+    // The SPI and PWM must not start before the new source runs
+    while ((OSCSTAT & to->ready) != to->ready);
+    OPTION_REGbits.PS = to->tmr0_ps;
+#endif
+
+    clock_level = level;
+    clock_tmr_count = (uint8_t) (256 - to->tmr0_counts);
+#if (PWM_DRIVE == PWM_DRIVE_HALF)
+    // Dead band in instruction cycles, no auto-restart (P1RSEN = 0)
+    PWM1CON = to->dead_band;
+#endif
+    clock_pwm(clock_pitch);
+
+#elif defined HOST_BUILD
+
+    clock_level = level;
+
+#else
+
+#error Error! You must create definitions for this processor.
+
+#endif
+    return;
+}
+
+#if (__18F45K20 == 1) || (_18F45K20 == 1) || \
+    (__16F1823 == 1) || (_16F1823 == 1)
+
+/*! \brief clock_rescale
+ *
+ * Rescales what is left of the tick from the Timer0 rate of one level to
+ * that of another, an expired tick stays expired. Called with interrupts
+ * off, the Timer0 interrupt must not reload it in between.
+ */
+static void clock_rescale(uint8_t from, uint8_t to)
+{
+    uint8_t remaining;
+
+    if (TIMER_EXPIRED)
+    {
+        return;
+    }
+
+    remaining = (uint8_t) (256 - CLOCK_TMR0);
+    if (clock_levels[to].tmr0_shift > clock_levels[from].tmr0_shift)
+    {
+        remaining <<= (clock_levels[to].tmr0_shift
+                - clock_levels[from].tmr0_shift);
+        if ((remaining == 0) || (remaining > clock_levels[to].tmr0_counts))
+        {
+            remaining = clock_levels[to].tmr0_counts;
+        }
+    }
+    else
+    {
+        remaining >>= (clock_levels[from].tmr0_shift
+                - clock_levels[to].tmr0_shift);
+        if (remaining == 0)
+        {
+            remaining = 1;
+        }
+    }
+    CLOCK_TMR0 = (uint8_t) (256 - remaining);
+
+    return;
+}
+
+#endif
+
+/*! \brief clock_init
+ */
+void clock_init(void)
+{
+    clock_program(CLOCK_RUN);
+
+    return;
+}
+
+/*! \brief clock_set
+ *
+ * Raising the clock programs the oscillator before anything else, so the
+ * way back from CLOCK_IDLE runs as little as possible at the idle rate.
+ * The tick left is rescaled after, it is still in counts of the old level
+ * as only the prescaler has changed. Lowering the clock rescales first.
+ */
+uint8_t clock_set(uint8_t level)
+{
+    uint8_t previous = clock_level;
+#if (__18F45K20 == 1) || (_18F45K20 == 1) || \
+    (__16F1823 == 1) || (_16F1823 == 1)
+    uint8_t gie;
+#endif
+
+    if (level == previous)
+    {
+        return previous;
+    }
+
+#if (__18F45K20 == 1) || (_18F45K20 == 1) || \
+    (__16F1823 == 1) || (_16F1823 == 1)
+
+    gie = INTCONbits.GIE;
+    INTCONbits.GIE = 0;
+    if (level > previous)
+    {
+        clock_program(level);
+        clock_rescale(previous, level);
+    }
+    else
+    {
+        clock_rescale(previous, level);
+        clock_program(level);
+    }
+    INTCONbits.GIE = gie;
+
+#else
+
+    clock_program(level);
+
+#endif
+
+    return previous;
+}
+
+/*! \brief clock_pwm
+ */
+void clock_pwm(uint8_t pitch)
+{
+#if (__18F45K20 == 1) || (_18F45K20 == 1) || \
+    (__16F1823 == 1) || (_16F1823 == 1)
+
+    clock_tone_t const * tone = &clock_tones[clock_level][pitch];
+
+    clock_pitch = pitch;
+
+    // Timer 2 Period Register (PR2) = (<clk> / 4 / <prescale> / <freq>) - 1
+    T2CONbits.T2CKPS = tone->tmr2_ps;
+    PR2 = tone->pr2;
+
+    // Duty cycle to match
+    pwm_duty();
+
+#elif defined HOST_BUILD
+
+    clock_pitch = pitch;
+
+#else
+
+#error Error! You must create definitions for this processor.
+
+#endif
+    return;
+}
@@ -8,15 +8,19 @@
 #include <htc.h>        /* HiTech General Include File */
 #elif defined(__18CXX)
 #include <p18cxxx.h>    /* C18 General Include File */
+#elif defined(__MINGW32__) || defined(__unix__) || defined(__APPLE__)
+#include <registers.h>  /* Host Register File */
 #endif
 
-#if defined(__XC) || defined(HI_TECH_C) || defined (__MINGW32__)
+#if defined(__XC) || defined(HI_TECH_C) || defined (HOST_BUILD)
 
 #include <stdint.h>        /* For uint8_t definition */
 #include <stdbool.h>       /* For true/false definition */
 
 #endif
 
+#include "user.h"          /* For IDLE_MODE */
+
 /******************************************************************************/
 /* Configuration Bits                                                         */
 /*                                                                            */
@@ -69,13 +73,18 @@
 
 // CONFIG1
 #pragma config CPD = OFF, BOREN = OFF, IESO = OFF, FOSC = INTOSC
-#pragma config FCMEN = OFF, MCLRE = ON, WDTE = OFF, CP = OFF, PWRTE = OFF
+#pragma config FCMEN = OFF, MCLRE = ON, CP = OFF, PWRTE = OFF
 #pragma config CLKOUTEN = OFF
+#if (IDLE_MODE == IDLE_MODE_WDT) || defined (USAGE_LOG)
+#pragma config WDTE = SWDTEN    // Watchdog wakes idle(), usage_sleep()
+#else
+#pragma config WDTE = OFF
+#endif
 
 // CONFIG2
 #pragma config PLLEN = OFF, WRT = OFF, STVREN = OFF, BORV = LO, LVP = OFF
 
-#elif __MINGW32__
+#elif defined HOST_BUILD
 
 // Nothing to configure
 
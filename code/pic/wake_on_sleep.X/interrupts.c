@@ -0,0 +1,143 @@
+/*
+ ==============================================================================
+ Name        : interrupts.c
+ Date        : Oct 17, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2013, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+
+// Compiler specific includes
+#if defined(__XC)
+#include <xc.h>        /* XC8 General Include File */
+#elif defined(HI_TECH_C)
+#include <htc.h>       /* HiTech General Include File */
+#elif defined(__18CXX)
+#include <p18cxxx.h>   /* C18 General Include File */
+#elif defined(__MINGW32__) || defined(__unix__) || defined(__APPLE__)
+#include <registers.h> /* Host Register File */
+#endif
+
+#if defined(__XC) || defined(HI_TECH_C) || defined (HOST_BUILD)
+
+#include <stdint.h>        /* For uint8_t definition */
+#include <stdbool.h>       /* For true/false definition */
+
+#endif
+
+// Target includes
+#include "user.h"
+
+// Other includes
+#include "clock.h"
+#include "event.h"
+
+// Local declarations
+
+// Implementation
+
+#if (__18F45K20 == 1) || (_18F45K20 == 1) || \
+    (__16F1823 == 1) || (_16F1823 == 1)
+
+/*! \brief isr
+ *
+ * The only producer of the event ring. Each source is checked against its
+ * enable bit as well, a flag may be set with the interrupt disabled.
+ */
+void interrupt isr(void)
+{
+    // Timer0, the tick. Reload at once, the latency would add up.
+    if ((INTCONbits.TMR0IE == 1) && (TIMER_EXPIRED))
+    {
+        TIMER_RESET;
+        event_post(EVENT_TICK);
+    }
+
+    // nAWAKE, INT0 or IOC on RA4
+    if ((nAWAKE_ENABLED == 1) && (nAWAKE_FLAG == 1))
+    {
+        nAWAKE_CLEAR;
+        event_post(EVENT_NAWAKE);
+    }
+
+    // Timer2, armed by pwm_stop() for one period. TMR2IF stays set, it
+    // tells pwm_service() the zero duty cycle has been latched.
+    if ((PIE1bits.TMR2IE == 1) && (PIR1bits.TMR2IF == 1))
+    {
+        PIE1bits.TMR2IE = 0;
+        event_post(EVENT_PWM);
+    }
+
+    return;
+}
+
+#elif defined HOST_BUILD
+
+/*! \brief isr
+ *
+ * Polled by idle(). The stopping tone is off at once on the host, so only
+ * the tick and nAWAKE are sources. Both nAWAKE edges are posted.
+ */
+void isr(void)
+{
+    uint8_t level;
+
+    if (TIMER_EXPIRED)
+    {
+        TIMER_RESET;
+        event_post(EVENT_TICK);
+    }
+
+    level = nAWAKE ? 1 : 0;
+    if (level != host_registers.nawake)
+    {
+        host_registers.nawake = level;
+        event_post(EVENT_NAWAKE);
+    }
+
+    return;
+}
+
+#else
+
+#error Error! You must create definitions for this processor.
+
+#endif
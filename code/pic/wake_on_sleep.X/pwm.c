@@ -51,9 +51,11 @@
 #include <htc.h>       /* HiTech General Include File */
 #elif defined(__18CXX)
 #include <p18cxxx.h>   /* C18 General Include File */
+#elif defined(__MINGW32__) || defined(__unix__) || defined(__APPLE__)
+#include <registers.h> /* Host Register File */
 #endif
 
-#if defined(__XC) || defined(HI_TECH_C) || defined (__MINGW32__)
+#if defined(__XC) || defined(HI_TECH_C) || defined (HOST_BUILD)
 
 #include <stdint.h>        /* For uint8_t definition */
 #include <stdbool.h>       /* For true/false definition */
@@ -65,13 +67,46 @@
 
 // Module include
 #include "pwm.h"
-
-#define PWM_FREQ (2048) // 2.048 kHz
+#include "clock.h"
 
 // Local declarations
 
+// Stop requested, the output is muted until the peripheral is off
+static bool pwm_stopping;
+
+// Duty cycle, sixteenths of the period
+static uint8_t pwm_level = PWM_DUTY;
+
+static bool pwm_output_low(void);
+
 // Implementation
 
+/*! \brief pwm_output_low
+ *
+ * The muted output is low for good once the zero duty cycle has been
+ * latched, at the first period boundary after pwm_stop() cleared TMR2IF.
+ * Part way into a period says nothing, the old duty cycle may still have
+ * been latched for it.
+ */
+static bool pwm_output_low(void)
+{
+#if (__18F45K20 == 1) || (_18F45K20 == 1) || \
+    (__16F1823 == 1) || (_16F1823 == 1)
+
+    return (PIR1bits.TMR2IF == 1);
+
+#elif defined HOST_BUILD
+
+    // No period to wait for
+    return true;
+
+#else
+
+#error Error! You must create definitions for this processor.
+
+#endif
+}
+
 /*! \brief pwm_init
  */
 void pwm_init(void)
@@ -82,92 +117,76 @@ void pwm_init(void)
     PWM_TRIS = 0;
 
     // Set up 8-bit Timer2 to generate the PWM period (frequency)
-    // Prescale = 4, timer off, postscale not used with CCP module
+    // Timer off, postscale not used with CCP module
     T2CONbits.T2OUTPS = 0b0000;
     T2CONbits.TMR2ON = 0b0;
-    T2CONbits.T2CKPS = 0b01;
 
-    // Timer 2 Period Register (PR2) = (<clk> / 4 / <prescale> / <freq>) - 1
-    // Thus, the PWM frequency is:
-    // 8MHz clock / 4 = 2MHz instruction rate.
-    // (2MHz / <prescale>) / <PR2+1>)
-    PR2 = (FCY / 4 / 2048) - 1;
+    // Timer2 prescale, period (PR2) and the ten-bit 50% duty cycle
+    // (CCPR1L<7,0>:DC1B1:DC1B0) follow the clock level, see clock.c
+    clock_pwm(PWM_PITCH_MID);
 
-    // The Duty Cycle is controlled by the ten-bit CCPR1L<7,0>:DC1B1:DC1B0
-    // 50% Duty Cycle = 0.5 * (<PR2+1> * 4)
-    // The 8 most significant bits of the value are needed here
-    CCPR1L = (((((PR2+1) * 2) >> 2)) & 0xFF);
+#if (PWM_DRIVE == PWM_DRIVE_HALF)
+    PWM_TRIS_B = 0;
 
+    // P1Mx = 10 Half-Bridge output, P1A modulated and P1B its
+    // complement, both edges delayed by the dead band (see clock.c).
+    // CCP1Mx = 1100, PWM mode with P1A, P1B active-high.
+    CCP1CONbits.P1M = 0b10;
+#else
     // P1Mx = 01 Full-Bridge output forward, so we get the PWM
     // signal on P1D to LED7.  Only Single Output (00) is needed,
     // but the P1A pin does not connect to a demo board LED
-    // The 2 least significant bits of the value are written
-    // to the DC1B1 and DC1B0 bits in CCP1CON
     // CCP1Mx = 1100, PWM mode with P1D active-high.
     CCP1CONbits.P1M = 0b01;
-    CCP1CONbits.DC1B = (((PR2+1) * 2) & 0x03);
+#endif
     CCP1CONbits.CCP1M = 0b1100;
 
 #elif (__16F1823 == 1) || (_16F1823 == 1)
 
-#define TMR2_PRESCALE (1)
-
-    // PWM Period = [(PR2)+ 1] * 4 * Tosc * TMR2PS
-    // 1 / PWM_Freq = [(PR2)+ 1] * 4 * (1 / Fosc) * TMR2PS
-    // PR2 = (Fosc / (4 * TMR2PS * PWM_Freq)) - 1
-#define PWM_PERIOD ((FOSC / (4 * TMR2_PRESCALE * PWM_FREQ)) - 1)
-
     // Disable the CCP1 pin output driver by setting
     // the associated TRIS bit.
     PWM_TRIS = 1;
+#if (PWM_DRIVE == PWM_DRIVE_HALF)
+    PWM_TRIS_B = 1;
+#endif
 
-    // Load the PR2 register with the PWM period value.
-    PR2 = PWM_PERIOD;
+    // Load the Timer2 prescale, the PR2 register with the PWM period
+    // value and CCPR1L:DC1B with the 50% duty cycle for the clock
+    // level, see clock.c
+    clock_pwm(PWM_PITCH_MID);
 
     // CCP1CON: CCP1 CONTROL REGISTER
     // Configure the CCP1 module for the PWM mode
     // by loading the CCP1CON register with the
     // appropriate values.
 
-    // The Duty Cycle is controlled by the ten-bit CCPR1L<7,0>:DC1B1:DC1B0
-    // 50% Duty Cycle = 1/2 * [(PWM_PERIOD)+ 1] * 4
-    // Pulse Width = ([(PWM_PERIOD)+ 1] * 4) / 2
-#define PULSE_WIDTH ((((PWM_PERIOD)+ 1) * 4) / 2)
-
+#if (PWM_DRIVE == PWM_DRIVE_HALF)
+    // Half-Bridge output; P1A, P1B modulated with dead-band control;
+    // P1C, P1D assigned as port pins. The speaker sees +/-VDD.
+    CCP1CONbits.P1M = 0b10;
+#else
     // Single output; P1A modulated; P1B, P1C, P1D assigned as port pins
     CCP1CONbits.P1M = 0b00;
-    // These bits are the two LSbs of the PWM duty cycle. The eight MSbs
-    // are found in CCPR1L.
-    CCP1CONbits.DC1B = (PULSE_WIDTH & 0x03);
+#endif
     // PWM mode: P1A, P1C active-high; P1B, P1D active-high
     CCP1CONbits.CCP1M = 0b1100;
 
-    // Load the CCPR1L register and the DC1B1 bits
-    // of the CCP1CON register, with the PWM duty
-    // cycle value.
-
-    // The 8 most significant bits of the value are needed here
-    CCPR1L = ((PULSE_WIDTH >> 2) & 0xFF);
-
-    // Configure and start Timer2:
+    // Configure Timer2:
     // -Clear the TMR2IF interrupt flag bit of the
     //  PIR1 register.
     PIR1bits.TMR2IF = 0;
 
     // T2CON: TIMER2 CONTROL REGISTER
 
-    // -Configure the T2CKPS bits of the T2CON
-    // register with the Timer prescale value.
-    T2CONbits.T2CKPS = 0b00;// Prescaler is 1
-    // - Enable the Timer by setting the TMR2ON
-    // bit of the T2CON register.
-    T2CONbits.TMR2ON = 1;// Timer2 is on
+    // - Leave the Timer off until pwm_start(), idle() keeps the core
+    // awake for as long as TMR2ON is set.
+    T2CONbits.TMR2ON = 0;// Timer2 is off
 
     // Set up 8-bit Timer2 to generate the PWM period (frequency)
-    // Prescale = 4, timer off, postscale not used with CCP module
+    // Timer off, postscale not used with CCP module
     T2CONbits.T2OUTPS = 0b0000;// 1:1 Postscaler
 
-#elif defined __MINGW32__
+#elif defined HOST_BUILD
 
     // Nothing to configure
 
@@ -183,17 +202,31 @@ void pwm_init(void)
  */
 void pwm_start(void)
 {
+    // Cancel a pending stop
+    pwm_stopping = false;
+
 #if (__18F45K20 == 1) || (_18F45K20 == 1) || \
     (__16F1823 == 1) || (_16F1823 == 1)
 
+    // Unmute, the end of the period is no longer of interest
+    PIE1bits.TMR2IE = 0;
+    pwm_duty();
+
     // Enable the CCP1 pin output driver by clearing
     // the associated TRIS bit.
     PWM_TRIS = 0;
+#if (PWM_DRIVE == PWM_DRIVE_HALF)
+    PWM_TRIS_B = 0;
+#endif
 
     // Timer 2 on
     T2CONbits.TMR2ON = 1;
 
-#elif defined __MINGW32__
+#elif defined HOST_BUILD
+
+    pwm_duty();
+    PWM_TRIS = 0;
+    host_registers.tmr2on = 1;
 
 #else
 
@@ -203,29 +236,120 @@ void pwm_start(void)
     return;
 }
 
+/*! \brief pwm_pitch
+ */
+void pwm_pitch(uint8_t pitch)
+{
+    // Timer2 setup and duty cycle for the current clock level
+    clock_pwm(pitch);
+
+    return;
+}
+
+/*! \brief pwm_volume
+ */
+void pwm_volume(uint8_t duty)
+{
+    if (duty < PWM_DUTY_MIN)
+    {
+        duty = PWM_DUTY_MIN;
+    }
+    else if (duty > PWM_DUTY_MAX)
+    {
+        duty = PWM_DUTY_MAX;
+    }
+
+    pwm_level = duty;
+    pwm_duty();
+
+    return;
+}
+
 /*! \brief pwm_stop
  */
 void pwm_stop(void)
 {
+    // Check if the tone is on
+    if (pwm_is_on() == true)
+    {
+        // Mute, a zero duty cycle is latched at the end of the period
+        // (TMR2IF) and keeps the output low from then on. The Timer2
+        // interrupt posts EVENT_PWM for pwm_service() there. The zero duty
+        // is written before TMR2IF is cleared, a boundary in between would
+        // latch the old one and still set the flag.
+        pwm_stopping = true;
+        pwm_duty();
 #if (__18F45K20 == 1) || (_18F45K20 == 1) || \
     (__16F1823 == 1) || (_16F1823 == 1)
+        PIR1bits.TMR2IF = 0;
+        PIE1bits.TMR2IE = 1;
+#endif
 
-    // Check if the timer is on
-    if(T2CONbits.TMR2ON == 1)
-    {
-        // Wait until the Timer overflows and the TMR2IF bit of the PIR1
-        // register is set.
-        while (PIR1bits.TMR2IF == 0);
+        // Off now if the output already is low
+        pwm_service();
+    }
 
-        // Disable the CCP1 pin output driver by setting
-        // the associated TRIS bit.
-        PWM_TRIS = 1;
+    return;
+}
 
-        // Timer 2 off
-        T2CONbits.TMR2ON = 0;
+/*! \brief pwm_service
+ */
+void pwm_service(void)
+{
+    if ((pwm_stopping == false) || (pwm_output_low() == false))
+    {
+        return;
     }
 
-#elif defined __MINGW32__
+#if (__18F45K20 == 1) || (_18F45K20 == 1) || \
+    (__16F1823 == 1) || (_16F1823 == 1)
+
+    // Disable the CCP1 pin output driver by setting
+    // the associated TRIS bit. A muted half-bridge holds P1B high
+    // until here, the speaker then floats.
+    PWM_TRIS = 1;
+#if (PWM_DRIVE == PWM_DRIVE_HALF)
+    PWM_TRIS_B = 1;
+#endif
+
+    // Timer 2 off, its interrupt too if the output was low already
+    T2CONbits.TMR2ON = 0;
+    PIE1bits.TMR2IE = 0;
+
+#elif defined HOST_BUILD
+
+    PWM_TRIS = 1;
+    host_registers.tmr2on = 0;
+
+#else
+
+#error Error! You must create definitions for this processor.
+
+#endif
+
+    pwm_stopping = false;
+
+    return;
+}
+
+/*! \brief pwm_duty
+ */
+void pwm_duty(void)
+{
+#if (__18F45K20 == 1) || (_18F45K20 == 1) || \
+    (__16F1823 == 1) || (_16F1823 == 1)
+
+    // Duty Cycle = <level> / 16 * (<PR2+1> * 4), ten bits in
+    // CCPR1L<7,0>:DC1B
+    uint16_t duty = (pwm_stopping == true) ? 0 :
+            (((uint16_t) (PR2 + 1) * pwm_level) >> 2);
+
+    CCPR1L = (uint8_t) (duty >> 2);
+    CCP1CONbits.DC1B = (duty & 0x03);
+
+#elif defined HOST_BUILD
+
+    host_registers.pwm_duty = (pwm_stopping == true) ? 0 : pwm_level;
 
 #else
 
@@ -242,12 +366,13 @@ int pwm_is_on(void)
 #if (__18F45K20 == 1) || (_18F45K20 == 1) || \
     (__16F1823 == 1) || (_16F1823 == 1)
 
-    // Return timer state
-    return (T2CONbits.TMR2ON == 1);
+    // Return timer state, a stopping tone is already muted
+    return (T2CONbits.TMR2ON == 1) && (pwm_stopping == false);
+
+#elif defined HOST_BUILD
 
-#elif defined __MINGW32__
+    return (host_registers.tmr2on == 1) && (pwm_stopping == false);
 
-    return false;
 #else
 
 #error Error! You must create definitions for this processor.
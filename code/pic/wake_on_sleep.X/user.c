@@ -51,9 +51,11 @@
 #include <htc.h>       /* HiTech General Include File */
 #elif defined(__18CXX)
 #include <p18cxxx.h>   /* C18 General Include File */
+#elif defined(__MINGW32__) || defined(__unix__) || defined(__APPLE__)
+#include <registers.h> /* Host Register File */
 #endif
 
-#if defined(__XC) || defined(HI_TECH_C) || defined (__MINGW32__)
+#if defined(__XC) || defined(HI_TECH_C) || defined (HOST_BUILD)
 
 #include <stdint.h>        /* For uint8_t definition */
 #include <stdbool.h>       /* For true/false definition */
@@ -63,6 +65,12 @@
 // Module include
 #include "user.h"
 
+// Other includes
+#include "pwm.h"
+#include "clock.h"
+#include "event.h"
+#include "sw_timer.h"
+
 // Local declarations
 
 // Implementation
@@ -88,10 +96,16 @@ void init(void)
     // INTCON: INTERRUPT CONTROL REGISTER
     INTCONbits.INT0IE = 1; //1 = Enables the INT0 interrupt
     INTCONbits.INT0IF = 0; //clear
+    INTCONbits.TMR0IE = 1; //1 = Enables the Timer0 interrupt (tick)
     INTCONbits.TMR0IF = 0;// clear roll-over interrupt flag
+    INTCONbits.PEIE = 1; //1 = Enables peripheral interrupts (Timer2)
 
     // INTCON2: INTERRUPT CONTROL 2 REGISTER
     INTCON2bits.RBPU = 0; // enable PORTB internal pullups
+    INTCON2bits.INTEDG0 = 1; // INT0 on the rising edge (asleep)
+
+    // RCON: RESET CONTROL REGISTER
+    RCONbits.IPEN = 0; // One interrupt priority, see event.h
 
     // ANSEL: ANALOG SELECT REGISTER 1
     ANSEL  = 0x00;// AN0-7 are digital inputs
@@ -103,10 +117,21 @@ void init(void)
     TRISB = 0b00000001;// PORTB bit 7:1 are outputs, 0 is input
     LATB = 0b00000000;// All outputs [7:1] are low
 
+#if (SPI_DRIVER == SPI_DRIVER_MSSP)
     // Init Port-D (8-bits)
     TRISD = 0b00000000;// PORTD bits 7:0 are outputs
     LATD = 0b00000000;// All outputs [7:0] are low
 
+    // Init Port-C (8-bits), the MSSP drives SCK and SDO, SDI is an input
+    TRISC &= ~(MCLK | MOSI);// SCK, SDO are outputs
+    TRISC |= MISO;// SDI is an input
+    LATC &= ~(MCLK | MOSI);// Idle low
+#else
+    // Init Port-D (8-bits)
+    TRISD = MISO;// PORTD bits 7:0 are outputs, MISO is an input
+    LATD = 0b00000000;// All outputs [7:0] are low
+#endif
+
     // Init Timer0 (Main-loop clock)
 
     TMR0H = 0;// clear timer - always write upper byte first
@@ -156,11 +181,11 @@ void init(void)
     // core/Timer0 module and is FOSC/4
 
     // INTCON: INTERRUPT CONTROL REGISTER
-    INTCON = 0b00001000;
+    INTCON = 0b01101000;
     /*
-     INTCONbits.GIE = 0;// Disables all interrupts
-     INTCONbits.PEIE = 0;// Disables all peripheral interrupts
-     INTCONbits.TMR0IE = 0;// Disables the Timer0 interrupt
+     INTCONbits.GIE = 0;// Disables all interrupts (until init() ends)
+     INTCONbits.PEIE = 1;// Enables all peripheral interrupts (Timer2)
+     INTCONbits.TMR0IE = 1;// Enables the Timer0 interrupt (tick)
      INTCONbits.INTE = 0;// Disables the INT external interrupt
      INTCONbits.IOCIE = 1;// Enables the interrupt-on-change
      INTCONbits.TMR0IF = 0;// TMR0 register did not overflow(clear)
@@ -184,20 +209,124 @@ void init(void)
     LATA = 0b00000000;// All outputs [3:0,5] are low
 
     // Init Port-C (6-bits)
-    WPUC = 0b00000000;// disable pull up on port-C [5:0]
+    WPUC = MISO;// enable pull up on MISO, it floats while nCS is inactive
     ANSELC = 0b00000000;// ANSC0-3 are digital inputs
-    TRISC = 0b00000000;// PORTC bits 5:0 are outputs
+    TRISC = MISO;// PORTC bits 5:0 are outputs, MISO is an input
     LATC = 0b00000000;// All outputs [5:0] are low
 
-#elif defined __MINGW32__
+#if (IDLE_MODE == IDLE_MODE_WDT)
+    // WDTCON: WATCHDOG TIMER CONTROL REGISTER
+    WDTCONbits.WDTPS = WDT_PRESCALE;// Tick period
+    WDTCONbits.SWDTEN = 0;// Only enabled while idle
+#endif
+
+#elif defined HOST_BUILD
 
-    // Nothing to configure
+    // The tick, as TMR0IE on a target
+    host_registers.tmr0ie = 1;
 
 #else
 
 #error Error! You must create definitions for this processor.
 
 #endif
+
+    // Run clock, Timer0 prescale and reload, tone period
+    clock_init();
+
+    // Start posting events, see interrupts.c
+    INTERRUPTS_ON;
+
     return;
 }
 
+/*! \brief idle
+ */
+uint8_t idle(void)
+{
+    uint8_t event;
+#if (IDLE_MODE == IDLE_MODE_SPIN) || (IDLE_MODE == IDLE_MODE_IDLE)
+    // The tone needs the run clock, otherwise wait on the slowest one if
+    // no timer is due soon
+    uint8_t level = clock_set((pwm_is_on() ||
+            (sw_timer_next() < CLOCK_IDLE_TICKS)) ? CLOCK_RUN : CLOCK_IDLE);
+#endif
+
+#if (IDLE_MODE == IDLE_MODE_SPIN)
+
+    // Wait for the next event
+    while ((event = event_get()) == EVENT_NONE)
+    {
+#if defined HOST_BUILD
+        // No interrupts, poll the sources
+        isr();
+#endif
+    }
+
+    clock_set(level);
+
+#elif (IDLE_MODE == IDLE_MODE_IDLE) && \
+    ((__18F45K20 == 1) || (_18F45K20 == 1))
+
+    // IDLE on SLEEP, a plain SLEEP() elsewhere must still be a full sleep
+    OSCCONbits.IDLEN = 1;
+
+    // Interrupts are held off from the check to SLEEP(), an event raised
+    // in between leaves its flag set and SLEEP() falls through. The ISR
+    // then runs once they are back on, after the clock is back up so it
+    // does not run at the idle rate.
+    INTERRUPTS_OFF;
+    while ((event = event_get()) == EVENT_NONE)
+    {
+        SLEEP();
+        clock_set(level);
+        INTERRUPTS_ON;
+        NOP();
+        INTERRUPTS_OFF;
+    }
+    INTERRUPTS_ON;
+
+    OSCCONbits.IDLEN = 0;
+
+    // An event already pending skips the loop
+    clock_set(level);
+
+#elif (IDLE_MODE == IDLE_MODE_WDT) && \
+    ((__16F1823 == 1) || (_16F1823 == 1))
+
+    // As above, interrupts are held off from the check to SLEEP()
+    INTERRUPTS_OFF;
+    while ((event = event_get()) == EVENT_NONE)
+    {
+        // Timer2 stops in SLEEP, keep the core awake while sounding and
+        // let the Timer0 interrupt tick
+        if (T2CONbits.TMR2ON == 0)
+        {
+            CLRWDT();
+            WDTCONbits.SWDTEN = 1;
+            SLEEP();
+            WDTCONbits.SWDTEN = 0;
+
+            // nTO is only cleared by a watchdog time-out, the tick. Timer0
+            // stops in SLEEP, restart it so it only ticks for a core that
+            // stays awake a whole tick.
+            if (STATUSbits.nTO == 0)
+            {
+                TIMER_RESET;
+                event = EVENT_TICK;
+                break;
+            }
+        }
+        INTERRUPTS_ON;
+        NOP();
+        INTERRUPTS_OFF;
+    }
+    INTERRUPTS_ON;
+
+#else
+
+#error Error! You must create definitions for this processor.
+
+#endif
+    return event;
+}
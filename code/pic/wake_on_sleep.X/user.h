@@ -68,20 +68,68 @@ extern "C"
 #define HIGH_BYTE(x)    ((unsigned char)(((x)>>8)&0xFF))
 #endif
 
+// Idle modes, how the main-loop waits for the next event (see idle())
+#define IDLE_MODE_SPIN  (0) // Busy-wait on the event ring
+#define IDLE_MODE_IDLE  (1) // Core IDLE, Timer0 keeps running and wakes it
+#define IDLE_MODE_WDT   (2) // Core SLEEP, watchdog time-out wakes it
+
+// SPI drivers for the ADXL362, select one with SPI_DRIVER
+#define SPI_DRIVER_GPIO (0) // Bit-banged on GPIO
+#define SPI_DRIVER_MSSP (1) // MSSP peripheral, SPI master mode
+#define SPI_DRIVER_HOST (2) // Host build, bytes go to host_hooks.spi_xchg
+
+#ifndef SPI_DRIVER
+#if defined(HOST_BUILD)
+#define SPI_DRIVER      SPI_DRIVER_HOST
+#else
+#define SPI_DRIVER      SPI_DRIVER_GPIO
+#endif
+#endif
+
+// Speaker drives, select one with PWM_DRIVE
+#define PWM_DRIVE_SINGLE (0) // P1A (P1D on the 18F) against ground
+#define PWM_DRIVE_HALF  (1) // P1A and complementary P1B across the speaker
+
+#ifndef PWM_DRIVE
+#define PWM_DRIVE       PWM_DRIVE_SINGLE
+#endif
+
 #if (__18F45K20 == 1) || (_18F45K20 == 1)
 
-#define SYS_FREQ        (8000000L) // Hz
+#define SYS_FREQ        (8000000L) // Hz, CLOCK_RUN (see clock.c)
 #define FOSC            SYS_FREQ
 #define _XTAL_FREQ      SYS_FREQ
 #define FCY             (SYS_FREQ/4)
 
-#define TMR0_PRESCALE   (256) // 1:256 See T0CON: TIMER0 CONTROL REGISTER
+// Idle mode, IDLE keeps Timer0 (and the PWM) running while the core stops
+#ifndef IDLE_MODE
+#define IDLE_MODE       IDLE_MODE_IDLE
+#endif
+
+#if (IDLE_MODE == IDLE_MODE_WDT)
+#error IDLE_MODE_WDT is not supported on this processor, use IDLE_MODE_IDLE.
+#endif
 
 // Definitions for clock timer and delay
-#define TMR_CLOCK_USEC ((USEC_PER_SEC * TMR0_PRESCALE) / FCY) // 128 usec
-#define TMR_COUNT (256 - (USEC_PER_TICK / TMR_CLOCK_USEC)) // 256 - 78.125
+#define USEC_PER_TICK (10000) // 10.000 msec
+#define TMR_COUNT (clock_tmr_count) // Per clock level, see clock.h
 #define TIMER_EXPIRED (INTCONbits.TMR0IF)
 #define TIMER_RESET (TMR0 = TMR_COUNT);INTCONbits.TMR0IF = 0
+#define TIMER_ELAPSED ((uint8_t) (TMR0L - TMR_COUNT)) // Since TIMER_RESET
+
+// Tick off around a deep SLEEP(), a pending Timer0 interrupt would end it
+// at once. Timer0 is stopped as well, the tick starts over after.
+#define TICK_STOP INTCONbits.TMR0IE = 0;T0CONbits.TMR0ON = 0; \
+    INTCONbits.TMR0IF = 0
+#define TICK_START TIMER_RESET;T0CONbits.TMR0ON = 1;INTCONbits.TMR0IE = 1
+
+// Cycle counter (FSM_PROFILE), Timer1 free-running on FOSC/4
+#define CYCLES_START (T1CON = 0b00000001) // 8-bit reads, 1:1, on
+#define CYCLES_HIGH (TMR1H)
+#define CYCLES_LOW (TMR1L)
+
+// Fixed voltage reference, VDD is measured against it (see battery.c)
+#define FVR_MV          (1200) // 1.2 V
 
 // Definitions for GPIO
 
@@ -89,27 +137,68 @@ extern "C"
 #define SB0         (0b00000010) // RD1
 #define SB1         (0b00000100) // RD2
 
+#if (SPI_DRIVER == SPI_DRIVER_MSSP)
+
+// MSSP-SPI
+#define MCLK        (0b00001000) // RC3 (SCK)
+#define MOSI        (0b00100000) // RC5 (SDO)
+#define MISO        (0b00010000) // RC4 (SDI)
+#define nCS         (0b01000000) // RD6
+
+// MSSP registers
+#define SPI_CON1     (SSPCON1)
+#define SPI_STAT     (SSPSTAT)
+#define SPI_BUF      (SSPBUF)
+#define SPI_BUF_FULL (SSPSTATbits.BF)
+
+#else
+
 // GPIO-SPI
 #define MCLK        (0b00001000) // RD3
 #define MOSI        (0b00010000) // RD4
 #define MISO        (0b00100000) // RD5
 #define nCS         (0b01000000) // RD6
 
+#endif
+
 // GPIO Speaker
+#if (PWM_DRIVE == PWM_DRIVE_HALF)
+#if (SPI_DRIVER != SPI_DRIVER_MSSP)
+#error PWM_DRIVE_HALF needs P1B (RD5, MISO of the GPIO-SPI), use SPI_DRIVER_MSSP.
+#endif
+#define PWM_TRIS     (TRISCbits.TRISC2) // RC2 (P1A)
+#define PWM_TRIS_B   (TRISDbits.TRISD5) // RD5 (P1B)
+#else
 #define PWM_TRIS     (TRISDbits.TRISD7) // RD7
+#endif
 
 // GPIO Ports
 #define HEARTBEAT_PORT (LATD)
 #define STATE_PORT     (LATD)
 
+#if (SPI_DRIVER == SPI_DRIVER_MSSP)
+#define SPI_MCLK_PORT  (LATC)
+#define SPI_MOSI_PORT  (LATC)
+#define SPI_MISO_PORT  (PORTC) // Input
+#else
 #define SPI_MCLK_PORT  (LATD)
 #define SPI_MOSI_PORT  (LATD)
-#define SPI_MISO_PORT  (LATD)
+#define SPI_MISO_PORT  (PORTD) // Input
+#endif
 #define SPI_nCS_PORT   (LATD)
 
 // Input signals
 #define nAWAKE (PORTBbits.INT0) // INT0
 #define nAWAKE_CLEAR (INTCONbits.INT0IF = 0)
+#define nAWAKE_FLAG (INTCONbits.INT0IF)
+#define nAWAKE_ENABLED (INTCONbits.INT0IE)
+#define nAWAKE_DISABLE (INTCONbits.INT0IE = 0) // For good, end of life
+#define nAWAKE_RISE (INTCON2bits.INTEDG0 = 1) // Interrupt on asleep
+#define nAWAKE_FALL (INTCON2bits.INTEDG0 = 0) // Interrupt on activity
+
+// Interrupts (single priority, IPEN = 0)
+#define INTERRUPTS_ON (INTCONbits.GIE = 1)
+#define INTERRUPTS_OFF (INTCONbits.GIE = 0)
 
 // Current State Mask
 #define STATE_MASK (SB0 | SB1)
@@ -117,18 +206,49 @@ extern "C"
 
 #elif (__16F1823 == 1) || (_16F1823 == 1)
 
-#define SYS_FREQ        (500000L) // Hz
+#define SYS_FREQ        (500000L) // Hz, CLOCK_RUN (see clock.c)
 #define FOSC            SYS_FREQ
 #define _XTAL_FREQ      SYS_FREQ
 #define FCY             (SYS_FREQ/4)
 
-#define TMR0_PRESCALE   (16) // 1:16 See OPTION_REG (PS)
+// Idle mode, there is no IDLE mode on this core and Timer0 stops in
+// SLEEP, so the watchdog (LFINTOSC) is used as the tick wake-up source.
+// The oscillator is off between ticks then, CLOCK_IDLE only has an
+// effect on the 18F45K20 (and with IDLE_MODE_SPIN). CLOCK_FAST still
+// runs the SPI bursts, see clock.h.
+#ifndef IDLE_MODE
+#define IDLE_MODE       IDLE_MODE_WDT
+#endif
+
+#if (IDLE_MODE == IDLE_MODE_IDLE)
+#error IDLE_MODE_IDLE is not supported on this processor, use IDLE_MODE_WDT.
+#elif (IDLE_MODE == IDLE_MODE_WDT)
+// The watchdog only has power-of-two periods, use 1:256 (8 msec typ.)
+#define WDT_PRESCALE    (0b00011) // 1:256 See WDTCON (WDTPS)
+#define USEC_PER_TICK   (8000) // 8.000 msec
+#else
+#define USEC_PER_TICK   (10000) // 10.000 msec
+#endif
 
 // Definitions for clock timer and delay
-#define TMR_CLOCK_USEC ((USEC_PER_SEC * TMR0_PRESCALE) / FCY) // 128 usec
-#define TMR_COUNT (256 - (USEC_PER_TICK / TMR_CLOCK_USEC)) // 256 - 78.125
+#define TMR_COUNT (clock_tmr_count) // Per clock level, see clock.h
 #define TIMER_EXPIRED (INTCONbits.TMR0IF)
 #define TIMER_RESET (TMR0 = TMR_COUNT);INTCONbits.TMR0IF = 0
+#define TIMER_ELAPSED ((uint8_t) (TMR0 - TMR_COUNT)) // Since TIMER_RESET
+
+// Tick off around a deep SLEEP(), a pending Timer0 interrupt would end it
+// at once. Timer0 stops in SLEEP by itself, the tick starts over after.
+#define TICK_STOP INTCONbits.TMR0IE = 0;INTCONbits.TMR0IF = 0
+#define TICK_START TIMER_RESET;INTCONbits.TMR0IE = 1
+
+// Cycle counter (FSM_PROFILE), Timer1 free-running on FOSC/4
+#define CYCLES_START (T1CON = 0b00000001) // FOSC/4, 1:1, on
+#define CYCLES_HIGH (TMR1H)
+#define CYCLES_LOW (TMR1L)
+
+// Fixed voltage reference, VDD is measured against it (see battery.c)
+#define FVR_MV          (1024) // 1.024 V (1x)
+#define BATTERY_ACQ_USEC (5) // ADC acquisition
 
 // Definitions for GPIO
 
@@ -136,14 +256,36 @@ extern "C"
 #define SB0         (0b00001000) // RC3
 #define SB1         (0b00010000) // RC4
 
+#if (SPI_DRIVER == SPI_DRIVER_MSSP)
+
+// MSSP-SPI, the MSSP pins are fixed and rotate all three nets of the
+// GPIO-SPI map below: MCLK RC2 -> RC0, MISO RC0 -> RC1, MOSI RC1 -> RC2
+#define MCLK        (0b00000001) // RC0 (SCK)
+#define MOSI        (0b00000100) // RC2 (SDO)
+#define MISO        (0b00000010) // RC1 (SDI)
+#define nCS         (0b00000100) // RA2
+
+// MSSP registers
+#define SPI_CON1     (SSP1CON1)
+#define SPI_STAT     (SSP1STAT)
+#define SPI_BUF      (SSP1BUF)
+#define SPI_BUF_FULL (SSP1STATbits.BF)
+
+#else
+
 // GPIO-SPI
 #define MCLK        (0b00000100) // RC2
 #define MOSI        (0b00000010) // RC1
 #define MISO        (0b00000001) // RC0
 #define nCS         (0b00000100) // RA2
 
+#endif
+
 // GPIO Speaker
-#define PWM_TRIS     (TRISCbits.TRISC5) // RC5
+#define PWM_TRIS     (TRISCbits.TRISC5) // RC5 (P1A)
+#if (PWM_DRIVE == PWM_DRIVE_HALF)
+#define PWM_TRIS_B   (TRISCbits.TRISC4) // RC4 (P1B), takes over SB1
+#endif
 
 // GPIO Ports
 #define HEARTBEAT_PORT (LATA)
@@ -151,26 +293,56 @@ extern "C"
 
 #define SPI_MCLK_PORT  (LATC)
 #define SPI_MOSI_PORT  (LATC)
-#define SPI_MISO_PORT  (LATC)
+#define SPI_MISO_PORT  (PORTC) // Input
 #define SPI_nCS_PORT   (LATA)
 
 // Input signals
 #define nAWAKE (PORTAbits.RA4) // RA4
 #define nAWAKE_CLEAR (IOCAFbits.IOCAF4 = 0)
-
-// Current State Mask
+#define nAWAKE_FLAG (IOCAFbits.IOCAF4)
+#define nAWAKE_ENABLED (INTCONbits.IOCIE)
+#define nAWAKE_DISABLE (INTCONbits.IOCIE = 0) // For good, end of life
+#define nAWAKE_RISE (IOCAN = 0b00000000, IOCAP = 0b00010000) // On asleep
+#define nAWAKE_FALL (IOCAP = 0b00000000, IOCAN = 0b00010000) // On activity
+
+// Interrupts
+#define INTERRUPTS_ON (INTCONbits.GIE = 1)
+#define INTERRUPTS_OFF (INTCONbits.GIE = 0)
+
+// Current State Mask, only SB0 is left when P1B drives the speaker
+#if (PWM_DRIVE == PWM_DRIVE_HALF)
+#define STATE_MASK (SB0)
+#else
 #define STATE_MASK (SB0 | SB1)
+#endif
 #define STATE_BITS_SHIFT (3)
 
-#elif defined __MINGW32__
+#elif defined HOST_BUILD
 
-// Bring in some fake registers just so everything compiles
-extern uint8_t dummy_port;
+// Host (off-target) build, see registers.h for the register file and hooks
 
-// Definitions for clock timer and delay
+// Idle mode
+#define IDLE_MODE IDLE_MODE_SPIN
+
+// Tick of the target modelled, the 18F45K20 unless HOST_TARGET_16F1823
+// is defined for the watchdog tick of the 16F1823
+#if defined (HOST_TARGET_16F1823)
+#define USEC_PER_TICK (8000)
+#else
 #define USEC_PER_TICK (10000)
-#define TIMER_EXPIRED (dummy_port)
-#define TIMER_RESET dummy_port = 0;
+#endif
+
+// Definitions for clock timer and delay
+#define TIMER_EXPIRED (host_hooks.timer_expired())
+#define TIMER_RESET host_hooks.timer_reset()
+#define TIMER_ELAPSED (0) // Since TIMER_RESET, no host timer
+
+// Tick off around a deep SLEEP(), a model may end SLEEP() on it
+#define TICK_STOP (host_registers.tmr0ie = 0)
+#define TICK_START TIMER_RESET;host_registers.tmr0ie = 1
+
+// Fixed voltage reference, host_hooks.adc_fvr converts it (see battery.c)
+#define FVR_MV          (1024)
 
 // Definitions for GPIO
 
@@ -184,28 +356,43 @@ extern uint8_t dummy_port;
 #define MISO        (0b00000001) // RC0
 #define nCS         (0b00000100) // RA2
 
+#if (SPI_DRIVER == SPI_DRIVER_MSSP)
+#error The host build has no MSSP, use SPI_DRIVER_HOST or SPI_DRIVER_GPIO.
+#endif
+
+#if (PWM_DRIVE == PWM_DRIVE_HALF)
+#error The host build has no ECCP, use PWM_DRIVE_SINGLE.
+#endif
+
 // GPIO Speaker
-#define PWM_TRIS     (dummy_port) // RC5
+#define PWM_TRIS     (host_registers.pwm_tris) // RC5
 
 // GPIO Ports
-#define HEARTBEAT_PORT (dummy_port)
-#define STATE_PORT     (dummy_port)
+#define HEARTBEAT_PORT (host_registers.lata)
+#define STATE_PORT     (host_registers.latc)
 
-#define SPI_MCLK_PORT  (dummy_port)
-#define SPI_MOSI_PORT  (dummy_port)
-#define SPI_MISO_PORT  (dummy_port)
-#define SPI_nCS_PORT   (dummy_port)
+#define SPI_MCLK_PORT  (host_registers.latc)
+#define SPI_MOSI_PORT  (host_registers.latc)
+#define SPI_MISO_PORT  (host_registers.portc) // Input
+#define SPI_nCS_PORT   (host_registers.lata)
 
-// Input signals
-#define nAWAKE (dummy_port)
-#define nAWAKE_CLEAR (dummy_port = 0)
+// Input signals, isr() posts both edges
+#define nAWAKE (host_hooks.nawake())
+#define nAWAKE_CLEAR (host_hooks.nawake_clear())
+#define nAWAKE_DISABLE ((void) 0)
+#define nAWAKE_RISE ((void) 0)
+#define nAWAKE_FALL ((void) 0)
+
+// Interrupts, none on the host, idle() polls isr() instead
+#define INTERRUPTS_ON ((void) 0)
+#define INTERRUPTS_OFF ((void) 0)
 
 // Current State Mask
 #define STATE_MASK (SB0 | SB1)
 #define STATE_BITS_SHIFT (3)
 
 // CPU Sleep
-#define SLEEP()
+#define SLEEP() host_hooks.sleep()
 
 #else
 
@@ -229,6 +416,45 @@ extern uint8_t dummy_port;
 /* ************************************************************************** */
 void init(void);
 
+/* ************************************************************************** */
+/*!
+ \ingroup user
+
+ \brief idle
+
+ Waits for the next event. Depending on IDLE_MODE the core either spins
+ on the event ring or is put to sleep until an interrupt posts to it. In
+ IDLE_MODE_WDT the watchdog time-out is the tick, it is returned without
+ going through the ring.
+
+ \param[in] None.
+
+ \return The event, see event.h.
+
+ */
+/* ************************************************************************** */
+uint8_t idle(void);
+
+/* ************************************************************************** */
+/*!
+ \ingroup user
+
+ \brief isr
+
+ Interrupt service routine, see interrupts.c. Posts a Timer0 overflow as
+ EVENT_TICK, an nAWAKE edge as EVENT_NAWAKE and the end of the period of
+ a muted tone as EVENT_PWM. The host has no interrupts, idle() polls it.
+
+ \param[in] None.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+#if defined HOST_BUILD
+void isr(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
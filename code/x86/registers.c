@@ -44,27 +44,133 @@
  ==============================================================================
  */
 
+// nanosleep() is POSIX, not C99
+#define _POSIX_C_SOURCE 200809L
+
 // Standard includes
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdbool.h>
-
-// Other includes
+#include <string.h>
+#include <time.h>
 
 // Module include
 #include "registers.h"
 
-// Local declarations
+// Other includes
+#include "../pic/wake_on_sleep.X/user.h"
 
-#if defined (__MINGW32__)
+// Local declarations
 
-uint8_t dummy_port = 0;
+static bool host_timer_expired(void);
+static void host_timer_reset(void);
+static void host_sleep(void);
+static bool host_nawake(void);
+static void host_nawake_clear(void);
+static void host_spi_select(bool selected);
+static uint8_t host_spi_xchg(uint8_t data);
+static uint16_t host_adc_fvr(void);
 
-#else
+#define nAWAKE_PIN (0b00010000) // RA4
+#define HOST_VDD_MV (3000) // Fresh CR2032
 
-#error Do not use this file
+static const host_hooks_t host_default_hooks =
+{ host_timer_expired, host_timer_reset, host_sleep, host_nawake,
+        host_nawake_clear, host_spi_select, host_spi_xchg, host_adc_fvr };
 
-#endif
+host_registers_t host_registers;
+host_hooks_t host_hooks =
+{ host_timer_expired, host_timer_reset, host_sleep, host_nawake,
+        host_nawake_clear, host_spi_select, host_spi_xchg, host_adc_fvr };
 
 // Implementation
+
+/*! \brief host_timer_expired
+ *
+ * Paces the tick in real time.
+ */
+static bool host_timer_expired(void)
+{
+    struct timespec tick;
+
+    tick.tv_sec = USEC_PER_TICK / 1000000;
+    tick.tv_nsec = (USEC_PER_TICK % 1000000) * 1000L;
+    nanosleep(&tick, NULL);
+
+    return true;
+}
+
+/*! \brief host_timer_reset
+ */
+static void host_timer_reset(void)
+{
+    return;
+}
+
+/*! \brief host_sleep
+ *
+ * Nothing to wake the core, return at once.
+ */
+static void host_sleep(void)
+{
+    return;
+}
+
+/*! \brief host_nawake
+ */
+static bool host_nawake(void)
+{
+    return ((host_registers.porta & nAWAKE_PIN) != 0);
+}
+
+/*! \brief host_nawake_clear
+ */
+static void host_nawake_clear(void)
+{
+    return;
+}
+
+/*! \brief host_spi_select
+ */
+static void host_spi_select(bool selected)
+{
+    if (selected == true)
+    {
+        host_registers.lata &= ~nCS; // Active-low
+    }
+    else
+    {
+        host_registers.lata |= nCS; // Inactive
+    }
+
+    return;
+}
+
+/*! \brief host_spi_xchg
+ *
+ * MISO floats high on its pull-up without a device attached.
+ */
+static uint8_t host_spi_xchg(uint8_t data)
+{
+    (void) data;
+
+    return 0xFF;
+}
+
+/*! \brief host_adc_fvr
+ */
+static uint16_t host_adc_fvr(void)
+{
+    return ((uint32_t) FVR_MV * 1023) / HOST_VDD_MV;
+}
+
+/*! \brief host_reset
+ */
+void host_reset(void)
+{
+    memset(&host_registers, 0, sizeof(host_registers));
+    host_hooks = host_default_hooks;
+
+    return;
+}
@@ -52,9 +52,82 @@ extern "C"
 {
 #endif
 
-#if defined (__MINGW32__)
+/* ************************************************************************** */
+/*!
+ \defgroup registers Host Register File
 
-extern uint8_t dummy_port;
+ \brief Host (off-target) port of the controller.
+
+ Each port and flag the firmware touches is backed by its own field of
+ host_registers. Timer, SLEEP(), nAWAKE, SPI and ADC accesses call
+ through host_hooks, so a model of the time base, the accelerometer and
+ the battery can be plugged in. The defaults pace the tick in real time,
+ leave the accelerometer floating and read a fresh 3.0 V cell. Build
+ every C file under x86, common and pic/wake_on_sleep.X with GCC or
+ Clang, with -Ix86 -Icommon.
+
+ */
+/* ************************************************************************** */
+
+#if defined(__MINGW32__) || defined(__unix__) || defined(__APPLE__)
+
+#include <stdint.h>        /* For uint8_t definition */
+#include <stdbool.h>       /* For true/false definition */
+
+#define HOST_BUILD (1)
+
+/*
+ * Host registers, one backing store per port and flag.
+ */
+typedef struct _host_registers_t
+{
+    uint8_t porta; // Input
+    uint8_t portc; // Input
+    uint8_t lata;
+    uint8_t latc;
+    uint8_t pwm_tris;
+    uint8_t tmr2on;
+    uint8_t pwm_duty; // Sixteenths of the period, see pwm_volume()
+    uint8_t tmr0ie; // Tick interrupt enabled, TICK_START and TICK_STOP
+    uint8_t nawake; // nAWAKE as last seen by isr(), for its edges
+
+} host_registers_t, *host_registers_ptr_t;
+
+/*
+ * Host hooks.
+ */
+typedef struct _host_hooks_t
+{
+    bool (*timer_expired)(void); // TIMER_EXPIRED
+    void (*timer_reset)(void); // TIMER_RESET
+    void (*sleep)(void); // SLEEP()
+    bool (*nawake)(void); // nAWAKE
+    void (*nawake_clear)(void); // nAWAKE_CLEAR
+    void (*spi_select)(bool selected); // nCS
+    uint8_t (*spi_xchg)(uint8_t data); // One full-duplex byte
+    uint16_t (*adc_fvr)(void); // ADC count of FVR_MV against VDD
+
+} host_hooks_t, *host_hooks_ptr_t;
+
+extern host_registers_t host_registers;
+extern host_hooks_t host_hooks;
+
+/* ************************************************************************** */
+/*!
+ \ingroup registers
+
+ \brief host_reset
+
+ Clears the host registers and restores the default hooks.
+
+ \param[in] None.
+
+ \return Nothing.
+
+ */
+/* ************************************************************************** */
+
+void host_reset(void);
 
 #else
 